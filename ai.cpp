@@ -5,134 +5,991 @@
  * @copyright Copyright (c) 2023-2024
  */
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
 #include <cstdlib>
+#include <vector>
 
 #include "ai.h"
-#include "controller.h"
-#include <limits.h>
+#include "book.h"
+#include "endgame.h"
+#include "heuristic.h"
+#include "pattern.h"
+#include "symmetry.h"
+#include "threadpool.h"
+#include "trace.h"
+#include "transposition.h"
 
-#define DEPTH_LIMIT 7
-#define MAX_NODOS 1000000
+#define DEPTH_LIMIT 60
+#define GAME_TIME 180.0
+// Con estas casillas vacías o menos el final se resuelve exactamente
+#define ENDGAME_EMPTIES 20
+// Iteraciones que se buscan antes de resolver el final, para ordenar las jugadas
+#define ENDGAME_PRESEARCH_DEPTH 8
 
-Square getBestMove(GameModel &model)
+// Jugadas extra que se reservan al repartir el reloj
+#define RESERVE_MOVES 2
+// Tiempo mínimo por jugada, en segundos
+#define MIN_MOVE_TIME 0.02
+// Una iteración que se pasa del tiempo previsto puede usar hasta este múltiplo
+#define HARD_DEADLINE_FACTOR 2
+// Pasada esta fracción del tiempo previsto no se empieza otra iteración,
+// porque probablemente no termine a tiempo
+#define SOFT_DEADLINE_FRACTION 0.5
+// Cada cuántos nodos se mira el reloj
+#define TIME_CHECK_NODES 1024
+
+// Cerca de las hojas consultar la tabla u ordenar cuesta más de lo que ahorra
+#define TT_MIN_DEPTH 2
+#define ORDERING_MIN_DEPTH 2
+// Con estas casillas vacías o más, la tabla guarda las posiciones en su
+// orientación canónica: al principio de la partida abundan las simétricas
+#define TT_SYMMETRY_EMPTIES 48
+
+// Mayor que cualquier evaluación
+#define SCORE_INFINITY 1000000
+// Ventana de aspiración inicial alrededor del valor de una iteración anterior
+#define ASPIRATION_WINDOW 4
+
+/**
+ * @brief What a search move changed, so it can be taken back.
+ */
+struct MoveUndo
 {
-    Moves validMoves;
-    getValidMoves(model, validMoves);
+    int square;
+    Bitboard flips;
+    uint64_t hashKey;
+};
 
-    int bestValue = INT_MIN;
-    Square bestMove = validMoves[0];
+/**
+ * @brief Plays a move on a search position.
+ *
+ * @tparam P The colour of the side to move.
+ * @param node The search position.
+ * @param square The square index of the move.
+ * @return The information needed by undoPositionMove.
+ */
+template <Player P>
+static MoveUndo playPositionMove(SearchPosition &node, int square)
+{
+    MoveUndo undo;
+    undo.square = square;
+    undo.hashKey = node.hashKey;
+    undo.flips = makeMove(node.position, square);
 
-    int nodosEvaluados = 0;
+    node.hashKey ^= getMoveHashKey(P, square, undo.flips);
+    playPatternMove<P>(node.patterns, square, undo.flips);
+    node.player = getOpponent(P);
 
-    for (Square move : validMoves) {
-        GameModel newModel = model;  // Copia del modelo
-        playMove(newModel, move);   // Simula el movimiento
-        int moveValue = minimax(newModel, DEPTH_LIMIT, true, INT_MIN, INT_MAX, nodosEvaluados, MAX_NODOS);  // Llamada a minimax
+    return undo;
+}
 
-        if (moveValue > bestValue) {
-            bestValue = moveValue;
-            bestMove = move;
+/**
+ * @brief Takes back a move played with playPositionMove.
+ *
+ * @tparam P The colour of the side that moved.
+ * @param node The search position.
+ * @param undo The information returned by playPositionMove.
+ */
+template <Player P>
+static void undoPositionMove(SearchPosition &node, MoveUndo &undo)
+{
+    undoMove(node.position, undo.square, undo.flips);
+    node.hashKey = undo.hashKey;
+    node.player = P;
+    undoPatternMove<P>(node.patterns, undo.square, undo.flips);
+}
+
+/**
+ * @brief Passes on a search position. The opponent passing back takes
+ * the pass back.
+ *
+ * @tparam P The colour of the side to move.
+ * @param node The search position.
+ */
+template <Player P>
+static void playPositionPass(SearchPosition &node)
+{
+    passMove(node.position);
+    node.hashKey ^= getPassHashKey();
+    node.player = getOpponent(P);
+}
+
+/**
+ * @brief Checks whether a search position has no empty squares left.
+ *
+ * @param position The position.
+ * @return true or false.
+ */
+static bool isPositionFull(Position &position)
+{
+    return !~(position.player | position.opponent);
+}
+
+/**
+ * @brief Returns the number of empty squares of a position.
+ *
+ * @param position The position.
+ * @return The number of empty squares.
+ */
+static int getEmptyCount(Position &position)
+{
+    return BOARD_SIZE * BOARD_SIZE - countBits(position.player | position.opponent);
+}
+
+/**
+ * @brief Returns the transposition table key of a position.
+ *
+ * @param position The position.
+ * @param player The colour of the side to move.
+ * @param hashKey The position's key.
+ * @param symmetry Receives the symmetry that takes the position to the
+ * orientation its moves are stored in.
+ * @return The key.
+ */
+static uint64_t getTableKey(Position &position, Player player, uint64_t hashKey, int &symmetry)
+{
+    if (getEmptyCount(position) < TT_SYMMETRY_EMPTIES) {
+        symmetry = 0;
+        return hashKey;
+    }
+
+    Position canonical = getCanonicalPosition(position, symmetry);
+    if (!symmetry) {
+        return hashKey;
+    }
+
+    // Lo que la clave tiene además de la posición se conserva
+    return getHashKey(canonical, player) ^ getHashKey(position, player) ^ hashKey;
+}
+
+/**
+ * @brief Evaluates a search position from the side to move's point of view.
+ *
+ * @tparam P The colour of the side to move.
+ * @param node The search position.
+ * @param evaluator The evaluation function.
+ * @return The evaluation, in discs.
+ */
+template <Player P>
+static int evaluatePosition(SearchPosition &node, Evaluator evaluator)
+{
+    Position &position = node.position;
+
+    switch (evaluator) {
+    case EVALUATOR_DISCS:
+        return countBits(position.player) - countBits(position.opponent);
+
+    case EVALUATOR_PATTERNS:
+        if (hasPatternWeights()) {
+            return evaluatePatterns<P>(node.patterns, getEmptyCount(position));
         }
+        // Sin archivo de pesos, sigue con la heurística
+        [[fallthrough]];
+
+    default:
+        return evaluateHeuristic(position, getEmptyCount(position));
     }
+}
 
-    return bestMove;
+int getFinalScore(Position &position)
+{
+    int player = countBits(position.player);
+    int opponent = countBits(position.opponent);
+    int emptyCount = BOARD_SIZE * BOARD_SIZE - player - opponent;
+
+    if (player > opponent)
+        return player - opponent + emptyCount;
+    else if (player < opponent)
+        return player - opponent - emptyCount;
+    else
+        return 0;
+}
+
+void initSearchLimits(SearchLimits &limits)
+{
+    limits.maxDepth = DEPTH_LIMIT;
+    limits.maxNodes = 0;
+    limits.gameTime = GAME_TIME;
+    limits.threadCount = getHardwareThreadCount();
+    limits.parallelSearch = PARALLEL_LAZY_SMP;
+    limits.stop = nullptr;
+    limits.startTime = nullptr;
+    limits.endgameEmpties = ENDGAME_EMPTIES;
+    limits.evaluator = EVALUATOR_PATTERNS;
+    limits.useBook = true;
+    limits.bookSeed = nullptr;
+    limits.table = nullptr;
 }
 
-int minimax(GameModel &model, int depth, bool maximizingPlayer, int alpha, int beta, int &nodosEvaluados, int maxNodos) {
-    // Verificar si se excedió el número máximo de nodos
-    if (nodosEvaluados >= maxNodos) {
-        return evaluateBoard(model, getCurrentPlayer(model));  // Devolver la evaluación actual
+Square getBestMove(GameModel &model)
+{
+    SearchLimits limits;
+    initSearchLimits(limits);
+
+    return getBestMove(model, limits);
+}
+
+/**
+ * @brief Searches a position of a known colour with negamax principal
+ * variation search.
+ *
+ * The colour is resolved once per node: the children are searched with
+ * the other instance, so the move and evaluation code has no colour
+ * branches.
+ *
+ * @tparam P The colour of the side to move.
+ * @param node The search position.
+ * @param depth The remaining depth, in moves (passes are free).
+ * @param alpha The lower bound of the window.
+ * @param beta The upper bound of the window.
+ * @param state The search state.
+ * @return The score, from the side to move's point of view.
+ */
+template <Player P>
+static int searchNode(SearchPosition &node, int depth, int alpha, int beta, SearchState &state);
+
+/**
+ * @brief The root moves of an iteration, split between threads.
+ */
+struct RootSplit
+{
+    Moves *validMoves;
+    int depth;
+    int alpha;
+    int beta;
+
+    std::atomic<int> nextMove;
+    std::atomic<int> bestValue;
+    std::atomic<bool> cutoff;
+    int values[MAX_MOVES];
+};
+
+/**
+ * @brief Searches one root move of a split root.
+ *
+ * Moves after the first are searched with a null window just below the
+ * best value found so far by any thread, so moves that tie with it get
+ * an exact value too. That makes the chosen move independent of the
+ * order in which the threads finish.
+ *
+ * @tparam P The colour of the side to move.
+ * @param root The split root.
+ * @param node The search position.
+ * @param index The index of the move.
+ * @param state The search state of the thread.
+ */
+template <Player P>
+static void searchSplitRootMove(RootSplit &root, SearchPosition &node, int index, SearchState &state)
+{
+    int depth = root.depth;
+    int beta = root.beta;
+
+    MoveUndo undo = playPositionMove<P>(node, getSquareIndex((*root.validMoves)[index]));   // Simula el movimiento
+
+    int value;
+    if (index == 0) {
+        value = -searchNode<getOpponent(P)>(node, depth - 1, -beta, -root.alpha, state);
+    } else {
+        int alpha = root.bestValue.load() - 1;
+        value = -searchNode<getOpponent(P)>(node, depth - 1, -alpha - 1, -alpha, state);
+        if ((value > alpha) && (value < beta)) {
+            value = -searchNode<getOpponent(P)>(node, depth - 1, -beta, -alpha, state);
+        }
     }
 
-    Player currentPlayer = getCurrentPlayer(model);
+    undoPositionMove<P>(node, undo);   // Deshace el movimiento
 
-    // Condición de parada: Si llegamos al límite de profundidad o si el juego ha terminado
-    if (depth == 0 || gameIsOver(model)) {
-        return evaluateBoard(model, currentPlayer);
+    if (state.aborted) {
+        return;
     }
 
-    Moves validMoves;
-    getValidMoves(model, validMoves);
+    root.values[index] = value;
+
+    if (value >= beta) {
+        root.cutoff = true;
+    }
 
-    if (validMoves.size() == 0) {
-        // Si no hay movimientos válidos, simplemente devuelve la evaluación del tablero actual
-        return evaluateBoard(model, currentPlayer);
+    int bestValue = root.bestValue.load();
+    while ((value > bestValue) && !root.bestValue.compare_exchange_weak(bestValue, value))
+        ;
+}
+
+/**
+ * @brief Searches the root moves, split between the search threads.
+ *
+ * The first move is searched alone, to get a bound for the rest; the
+ * rest are handed out to the threads of state.splitStates. Each move's
+ * score slot receives its value, so the next iteration can search the
+ * best moves first.
+ *
+ * @tparam P The colour of the side to move.
+ * @param node The search position.
+ * @param validMoves The root moves.
+ * @param depth The search depth, including the root move.
+ * @param alpha The lower bound of the window.
+ * @param beta The upper bound of the window.
+ * @param state The search state of the main thread.
+ * @param bestMove Receives the best move.
+ * @return The best move's value.
+ */
+template <Player P>
+static int searchSplitRoot(SearchPosition &node,
+                           Moves &validMoves,
+                           int depth,
+                           int alpha,
+                           int beta,
+                           SearchState &state,
+                           Square &bestMove)
+{
+    // Se prueban primero las mejores jugadas de la iteración anterior
+    sortMoves(validMoves);
+
+    RootSplit root;
+    root.validMoves = &validMoves;
+    root.depth = depth;
+    root.alpha = alpha;
+    root.beta = beta;
+    root.nextMove = 1;
+    root.bestValue = alpha;
+    root.cutoff = false;
+    for (int i = 0; i < validMoves.size(); i++) {
+        root.values[i] = -SCORE_INFINITY - 1;
     }
 
-    // Incrementar el contador de nodos evaluados
-    nodosEvaluados++;
+    searchSplitRootMove<P>(root, node, 0, state);
+
+    if (!state.aborted && !root.cutoff) {
+        runThreadPool(state.splitCount, [&](int threadIndex) {
+            SearchPosition threadNode = node;
+            SearchState &threadState = state.splitStates[threadIndex];
 
-    if (maximizingPlayer) {
-        int maxEval = INT_MIN;
-        for (Square move : validMoves) {
-            GameModel newModel = model;  // Copiamos el modelo para simular el movimiento
-            playMove(newModel, move);     // Simulamos el movimiento
-            int eval = minimax(newModel, depth - 1, false, alpha, beta, nodosEvaluados, maxNodos);  // Llamada recursiva
-            maxEval = std::max(maxEval, eval);
-            alpha = std::max(alpha, eval);  // Actualizamos alpha
+            while (!threadState.aborted && !root.cutoff) {
+                int index = root.nextMove++;
+                if (index >= validMoves.size()) {
+                    break;
+                }
 
-            // Podar rama si es posible
-            if (beta <= alpha) {
-                break;  // No es necesario continuar explorando
+                searchSplitRootMove<P>(root, threadNode, index, threadState);
             }
+        });
+    }
 
-            // Verificar si hemos alcanzado el límite de nodos
-            if (nodosEvaluados >= maxNodos) {
-                break;
+    // Si un hilo no terminó sus jugadas, la iteración queda incompleta
+    for (int i = 0; i < state.splitCount; i++) {
+        if (state.splitStates[i].aborted) {
+            state.aborted = true;
+        }
+    }
+    if (state.aborted) {
+        return -SCORE_INFINITY;
+    }
+
+    // La mejor jugada es la de mayor valor; los empates se deciden por casilla
+    int bestValue = -SCORE_INFINITY;
+    int bestSquare = BOARD_SIZE * BOARD_SIZE;
+    for (int i = 0; i < validMoves.size(); i++) {
+        int value = root.values[i];
+        if (value < -SCORE_INFINITY) {
+            continue;
+        }
+
+        validMoves.scores[i] = value;
+
+        int square = getSquareIndex(validMoves[i]);
+        if ((value > bestValue) || ((value == bestValue) && (square < bestSquare))) {
+            bestValue = value;
+            bestSquare = square;
+            bestMove = validMoves[i];
+        }
+    }
+
+    return bestValue;
+}
+
+/**
+ * @brief Searches the root moves with principal variation search.
+ *
+ * Each move's score slot receives its value, so the next iteration can
+ * search the best moves first.
+ *
+ * @tparam P The colour of the side to move.
+ * @param node The search position.
+ * @param validMoves The root moves.
+ * @param depth The search depth, including the root move.
+ * @param alpha The lower bound of the window.
+ * @param beta The upper bound of the window.
+ * @param state The search state.
+ * @param bestMove Receives the best move.
+ * @return The best move's value.
+ */
+template <Player P>
+static int searchRoot(SearchPosition &node,
+                      Moves &validMoves,
+                      int depth,
+                      int alpha,
+                      int beta,
+                      SearchState &state,
+                      Square &bestMove)
+{
+    if (state.splitStates) {
+        return searchSplitRoot<P>(node, validMoves, depth, alpha, beta, state, bestMove);
+    }
+
+    int bestValue = -SCORE_INFINITY;
+
+    // Se prueban primero las mejores jugadas de la iteración anterior
+    sortMoves(validMoves);
+
+    for (int i = 0; i < validMoves.size(); i++) {
+        Square move = validMoves[i];
+        MoveUndo undo = playPositionMove<P>(node, getSquareIndex(move));   // Simula el movimiento
+
+        int value;
+        if (i == 0) {
+            value = -searchNode<getOpponent(P)>(node, depth - 1, -beta, -alpha, state);
+        } else {
+            // Ventana nula: solo se busca de nuevo si la jugada supera a la mejor
+            value = -searchNode<getOpponent(P)>(node, depth - 1, -alpha - 1, -alpha, state);
+            if ((value > alpha) && (value < beta)) {
+                value = -searchNode<getOpponent(P)>(node, depth - 1, -beta, -alpha, state);
             }
         }
-        return maxEval;
-    } else {
-        int minEval = INT_MAX;
-        for (Square move : validMoves) {
-            GameModel newModel = model;  // Copiamos el modelo para simular el movimiento
-            playMove(newModel, move);     // Simulamos el movimiento
-            int eval = minimax(newModel, depth - 1, true, alpha, beta, nodosEvaluados, maxNodos);   // Llamada recursiva
-            minEval = std::min(minEval, eval);
-            beta = std::min(beta, eval);  // Actualizamos beta
-
-            // Podar rama si es posible
-            if (beta <= alpha) {
-                break;  // No es necesario continuar explorando
+
+        undoPositionMove<P>(node, undo);   // Deshace el movimiento
+
+        if (state.aborted) {
+            break;
+        }
+
+        validMoves.scores[i] = value;
+
+        if (value > bestValue) {
+            bestValue = value;
+            bestMove = move;
+        }
+        if (value > alpha) {
+            alpha = value;
+        }
+        if (alpha >= beta) {
+            break;
+        }
+    }
+
+    return bestValue;
+}
+
+/**
+ * @brief Returns the nodes and leaves a search thread has searched so far,
+ * with those of the threads it splits the root with.
+ *
+ * @param state The search state.
+ * @param nodes Receives the nodes.
+ * @param leaves Receives the leaves.
+ */
+static void getSearchCounts(SearchState &state, uint64_t &nodes, uint64_t &leaves)
+{
+    if (!state.splitStates) {
+        nodes = state.nodes;
+        leaves = state.stats.leaves;
+        return;
+    }
+
+    nodes = 0;
+    leaves = 0;
+    for (int i = 0; i < state.splitCount; i++) {
+        nodes += state.splitStates[i].nodes;
+        leaves += state.splitStates[i].stats.leaves;
+    }
+}
+
+/**
+ * @brief Searches the root with iterative deepening.
+ *
+ * @param node The search position.
+ * @param validMoves The root moves.
+ * @param firstDepth The depth of the first iteration.
+ * @param maxDepth The depth of the last iteration.
+ * @param startTime The clock time when the move's time started.
+ * @param softTime No iteration starts after this many seconds.
+ * @param state The search state.
+ * @param info Receives the depth and score of the last completed iteration.
+ * @return The best move of the last completed iteration.
+ */
+static Square searchIteratively(SearchPosition &node,
+                                Moves &validMoves,
+                                int firstDepth,
+                                int maxDepth,
+                                std::atomic<double> &startTime,
+                                double softTime,
+                                SearchState &state,
+                                SearchInfo &info)
+{
+    Square bestMove = validMoves[0];
+
+    for (int i = 0; i < validMoves.size(); i++) {
+        validMoves.scores[i] = 0;
+    }
+
+    int emptyCount = getEmptyCount(node.position);
+    bool endgame = (maxDepth == emptyCount) && (emptyCount <= state.endgameEmpties);
+
+    int scores[BOARD_SIZE * BOARD_SIZE + 1];
+    bool hasScore[BOARD_SIZE * BOARD_SIZE + 1] = {false};
+    for (int depth = firstDepth; depth <= maxDepth; depth++) {
+        TRACE_SCOPE_VALUE("iteration", depth);
+
+        // Ventana de aspiración alrededor del valor de dos iteraciones atrás:
+        // el conteo de fichas oscila según quién juega la última jugada
+        bool aspiration = (depth - 2 >= firstDepth) && hasScore[depth - 2];
+        int window = ASPIRATION_WINDOW;
+        int alpha = aspiration ? (scores[depth - 2] - window) : -SCORE_INFINITY;
+        int beta = aspiration ? (scores[depth - 2] + window) : SCORE_INFINITY;
+
+        uint64_t iterationNodes;
+        uint64_t iterationLeaves;
+        getSearchCounts(state, iterationNodes, iterationLeaves);
+        double iterationTime = getClockTime();
+
+        Square iterationMove = bestMove;
+        while (true) {
+            int value = (node.player == PLAYER_BLACK)
+                            ? searchRoot<PLAYER_BLACK>(node, validMoves, depth, alpha, beta, state, iterationMove)
+                            : searchRoot<PLAYER_WHITE>(node, validMoves, depth, alpha, beta, state, iterationMove);
+
+            if (state.aborted) {
+                break;
             }
 
-            // Verificar si hemos alcanzado el límite de nodos
-            if (nodosEvaluados >= maxNodos) {
+            // Si el valor cae fuera de la ventana, se agranda y se busca de nuevo
+            if ((value <= alpha) || (value >= beta)) {
+                TRACE_EVENT_VALUE("aspirationFail", value);
+            }
+            if (value <= alpha) {
+                window *= 2;
+                alpha = std::max(value - window, -SCORE_INFINITY);
+            } else if (value >= beta) {
+                window *= 2;
+                beta = std::min(value + window, SCORE_INFINITY);
+            } else {
+                scores[depth] = value;
+                hasScore[depth] = true;
                 break;
             }
         }
-        return minEval;
+
+        // Una iteración interrumpida no se usa
+        if (state.aborted) {
+            break;
+        }
+
+        bestMove = iterationMove;
+        info.depth = depth;
+        info.score = scores[depth];
+
+        uint64_t nodes;
+        uint64_t leaves;
+        getSearchCounts(state, nodes, leaves);
+
+        SearchIterationStats &iteration = state.stats.iterations[state.stats.iterationCount++];
+        iteration.depth = depth;
+        iteration.nodes = nodes - iterationNodes;
+        iteration.leaves = leaves - iterationLeaves;
+        iteration.time = getClockTime() - iterationTime;
+
+        // No se empieza otra iteración que probablemente no termine a tiempo
+        if (getClockTime() >= startTime + softTime) {
+            TRACE_EVENT_VALUE("softDeadline", depth);
+            break;
+        }
+
+        // En el final, tras unas iteraciones que ordenan las jugadas, se resuelve
+        if (endgame && (depth >= ENDGAME_PRESEARCH_DEPTH) && (depth < maxDepth - 1)) {
+            depth = maxDepth - 1;
+        }
     }
+
+    return bestMove;
 }
 
-bool gameIsOver(GameModel& model){
+Square getBestMove(GameModel &model, SearchLimits &limits)
+{
+    SearchInfo info;
+
+    return getBestMove(model, limits, info);
+}
+
+Square getBestMove(GameModel &model, SearchLimits &limits, SearchInfo &info)
+{
+    TRACE_SCOPE("getBestMove");
+
+    double startTime = getClockTime();
+
+    SearchPosition node;
+    node.position = getPosition(model);
+    node.player = getCurrentPlayer(model);
+    node.hashKey = getHashKey(node.position, node.player);
+    initPatternIndices(node.position, node.player, node.patterns);
 
-    for (int y = 0; y < BOARD_SIZE; y++){
-        for (int x = 0; x < BOARD_SIZE; x++){
-            if(getBoardPiece(model, (Square){x,y}) == PIECE_EMPTY){
-                return false;
+    Position &position = node.position;
+    Moves validMoves;
+    getBitboardMoves(getMobility(position.player, position.opponent), validMoves);
+
+    info.depth = 0;
+    info.score = 0;
+    info.nodes = 0;
+    info.book = false;
+    info.stats = SearchStats();
+
+    Square bestMove = validMoves[0];
+    if (validMoves.size() == 1) {
+        info.time = getClockTime() - startTime;
+        return bestMove;
+    }
+
+    // Las jugadas del libro de aperturas no se buscan
+    int bookSquare;
+    if (limits.useBook && probeBook(position, limits.bookSeed, bookSquare, info.score, info.depth)) {
+        info.time = getClockTime() - startTime;
+        info.book = true;
+        return getIndexSquare(bookSquare);
+    }
+
+    // Se reparte el reloj que queda entre las jugadas propias que faltan
+    int emptyCount = getEmptyCount(position);
+    double remainingTime = limits.gameTime - getTimer(model, node.player);
+    double softTime = remainingTime / ((emptyCount + 1) / 2 + RESERVE_MOVES);
+    softTime = std::max(softTime, MIN_MOVE_TIME);
+    double hardTime = std::max(std::min(HARD_DEADLINE_FACTOR * softTime, remainingTime / 2),
+                               softTime);
+
+    // Al pensar durante el turno del rival, el tiempo empieza a correr
+    // cuando otro hilo fija el momento de inicio
+    std::atomic<double> localStartTime(startTime);
+    std::atomic<double> &moveStartTime = limits.startTime ? *limits.startTime : localStartTime;
+
+    // Un estado por hilo; todos se detienen juntos
+    int threadCount = std::max(limits.threadCount, 1);
+    std::atomic<bool> localStop(false);
+    std::atomic<bool> &stop = limits.stop ? *limits.stop : localStop;
+    TranspositionTable *table = limits.table ? limits.table : getSharedTranspositionTable();
+    std::vector<SearchState> states(threadCount);
+    for (SearchState &state : states) {
+        initMoveOrdering(state.ordering);
+        state.nodes = 0;
+        state.maxNodes = limits.maxNodes;
+        state.startTime = &moveStartTime;
+        state.hardTime = hardTime;
+        state.endgameEmpties = limits.endgameEmpties;
+        state.evaluator = limits.evaluator;
+        state.aborted = false;
+        state.stop = &stop;
+        state.table = table;
+        state.splitStates = nullptr;
+        state.splitCount = 1;
+        state.stats = SearchStats();
+    }
+
+    // Las entradas de jugadas anteriores siguen sirviendo, pero se reemplazan primero
+    ageTranspositionTable(table);
+
+    int maxDepth = std::min(limits.maxDepth, emptyCount);
+    if (limits.parallelSearch == PARALLEL_ROOT_SPLIT) {
+        // Solo el hilo principal profundiza; cada iteración le reparte las
+        // jugadas de la raíz a todos
+        states[0].splitStates = states.data();
+        states[0].splitCount = threadCount;
+
+        bestMove = searchIteratively(node,
+                                     validMoves,
+                                     1,
+                                     maxDepth,
+                                     moveStartTime,
+                                     SOFT_DEADLINE_FRACTION * softTime,
+                                     states[0],
+                                     info);
+        stop = true;
+    } else {
+        // Lazy SMP: todos los hilos buscan la misma posición y comparten la tabla.
+        // La mitad de los ayudantes va una iteración adelante, para que lleguen
+        // primero a las posiciones que el hilo principal buscará después
+        const SearchPosition rootNode = node;
+        const Moves rootMoves = validMoves;
+        runThreadPool(threadCount, [&](int threadIndex) {
+            TRACE_SCOPE(threadIndex ? "helperSearch" : "mainSearch");
+
+            SearchState &state = states[threadIndex];
+
+            if (threadIndex == 0) {
+                bestMove = searchIteratively(node,
+                                             validMoves,
+                                             1,
+                                             maxDepth,
+                                             moveStartTime,
+                                             SOFT_DEADLINE_FRACTION * softTime,
+                                             state,
+                                             info);
+
+                // Los ayudantes solo sirven mientras busca el hilo principal
+                stop = true;
+            } else {
+                SearchPosition helperNode = rootNode;
+                Moves helperMoves = rootMoves;
+                SearchInfo helperInfo;
+                searchIteratively(helperNode,
+                                  helperMoves,
+                                  1 + (threadIndex & 1),
+                                  maxDepth,
+                                  moveStartTime,
+                                  hardTime,
+                                  state,
+                                  helperInfo);
             }
-        }
+        });
     }
-    return true;
 
+    // Las iteraciones son las del hilo principal; los contadores, de todos
+    info.stats = states[0].stats;
+    info.nodes = states[0].nodes;
+    for (int i = 1; i < threadCount; i++) {
+        SearchStats &stats = states[i].stats;
+
+        info.stats.leaves += stats.leaves;
+        info.stats.expandedNodes += stats.expandedNodes;
+        info.stats.betaCutoffs += stats.betaCutoffs;
+        info.stats.firstMoveCutoffs += stats.firstMoveCutoffs;
+        info.stats.ttProbes += stats.ttProbes;
+        info.stats.ttHits += stats.ttHits;
+        info.stats.ttCutoffs += stats.ttCutoffs;
+        info.nodes += states[i].nodes;
+    }
+    info.time = getClockTime() - startTime;
+
+    return bestMove;
 }
 
-int evaluateBoard(GameModel& model, Player currentPlayer){
-    unsigned char white = 0;
-    unsigned char black = 0;
-    for (int y = 0; y < BOARD_SIZE; y++){
-        for (int x = 0; x < BOARD_SIZE; x++){
-            if(getBoardPiece(model, (Square){x,y}) == PIECE_WHITE){
-                white++;
+bool isSearchAborted(SearchState &state)
+{
+    if (state.aborted) {
+        return true;
+    }
+
+    state.nodes++;
+    if (((state.nodes % TIME_CHECK_NODES) == 0) &&
+        (*state.stop || (getClockTime() >= *state.startTime + state.hardTime))) {
+        TRACE_EVENT(*state.stop ? "stopped" : "hardDeadline");
+
+        state.aborted = true;
+        *state.stop = true;
+    }
+    if (state.maxNodes && (state.nodes > state.maxNodes)) {
+        TRACE_EVENT("nodeLimit");
+
+        state.aborted = true;
+    }
+
+    return state.aborted;
+}
+
+template <Player P>
+static int searchNode(SearchPosition &node, int depth, int alpha, int beta, SearchState &state)
+{
+    Position &position = node.position;
+
+    // Verificar si se acabó el tiempo o el límite de nodos
+    if (isSearchAborted(state)) {
+        return 0;
+    }
+
+    // Condición de parada: Si el juego terminó o llegamos al límite de profundidad
+    if (isPositionFull(position)) {
+        state.stats.leaves++;
+        return getFinalScore(position);
+    }
+
+    // Si la búsqueda llega al final del juego, la resuelve el solver de finales
+    int emptyCount = getEmptyCount(position);
+    if ((depth >= emptyCount) && (emptyCount <= state.endgameEmpties)) {
+        return solveEndgame(node, alpha, beta, state);
+    }
+    if (depth == 0) {
+        state.stats.leaves++;
+        return evaluatePosition<P>(node, state.evaluator);
+    }
+
+    Moves validMoves;
+    getBitboardMoves(getMobility(position.player, position.opponent), validMoves);
+
+    if (validMoves.empty()) {
+        if (!getMobility(position.opponent, position.player)) {
+            state.stats.leaves++;
+            return getFinalScore(position);
+        }
+
+        // Pasar es una jugada más, que no consume profundidad
+        playPositionPass<P>(node);
+        int value = -searchNode<getOpponent(P)>(node, depth, -beta, -alpha, state);
+        playPositionPass<getOpponent(P)>(node);
+
+        return value;
+    }
+
+    // Consultar la tabla de transposición
+    TTEntry entry;
+    int ttMove = TT_NO_MOVE;
+    int symmetry = 0;
+    uint64_t tableKey = node.hashKey;
+    if (depth >= TT_MIN_DEPTH) {
+        tableKey = getTableKey(position, P, node.hashKey, symmetry);
+        state.stats.ttProbes++;
+    }
+    if ((depth >= TT_MIN_DEPTH) && probeTranspositionTable(state.table, tableKey, entry)) {
+        state.stats.ttHits++;
+
+        if (entry.depth >= depth) {
+            if ((entry.bound == TT_BOUND_EXACT) ||
+                ((entry.bound == TT_BOUND_LOWER) && (entry.score >= beta)) ||
+                ((entry.bound == TT_BOUND_UPPER) && (entry.score <= alpha))) {
+                state.stats.ttCutoffs++;
+                return entry.score;
+            }
+        }
+
+        if (entry.move != TT_NO_MOVE) {
+            ttMove = untransformSquare(entry.move, symmetry);
+        }
+    }
+
+    // Ordenar las jugadas: primero la de la tabla, luego killers e historia
+    if (depth >= ORDERING_MIN_DEPTH) {
+        scoreMoves(state.ordering, position, P, validMoves, ttMove, depth);
+        sortMoves(validMoves);
+    }
+
+    int alphaOriginal = alpha;
+    int bestValue = -SCORE_INFINITY;
+    int bestMove = TT_NO_MOVE;
+    state.stats.expandedNodes++;
+
+    for (int i = 0; i < validMoves.size(); i++) {
+        int square = getSquareIndex(validMoves[i]);
+        MoveUndo undo = playPositionMove<P>(node, square);     // Simulamos el movimiento
+
+        int value;
+        if (i == 0) {
+            value = -searchNode<getOpponent(P)>(node, depth - 1, -beta, -alpha, state);
+        } else {
+            // Ventana nula: solo se busca de nuevo si la jugada supera a la mejor
+            value = -searchNode<getOpponent(P)>(node, depth - 1, -alpha - 1, -alpha, state);
+            if ((value > alpha) && (value < beta)) {
+                value = -searchNode<getOpponent(P)>(node, depth - 1, -beta, -alpha, state);
             }
-            else if(getBoardPiece(model, (Square){x,y}) == PIECE_BLACK)
-            {
-                black++;
+        }
+
+        undoPositionMove<P>(node, undo);     // Deshacemos el movimiento
+
+        // Verificar si la búsqueda se interrumpió
+        if (state.aborted) {
+            return 0;
+        }
+
+        if (value > bestValue) {
+            bestValue = value;
+            bestMove = square;
+        }
+        if (value > alpha) {
+            alpha = value;
+        }
+
+        // Podar rama si es posible
+        if (alpha >= beta) {
+            state.stats.betaCutoffs++;
+            if (i == 0) {
+                state.stats.firstMoveCutoffs++;
             }
+
+            updateMoveOrdering(state.ordering, position, P, square, depth);
+            break;  // No es necesario continuar explorando
         }
     }
 
+    // Guardar el resultado
+    if (depth >= TT_MIN_DEPTH) {
+        TTBound bound = TT_BOUND_EXACT;
+        if (bestValue <= alphaOriginal) {
+            bound = TT_BOUND_UPPER;
+        } else if (bestValue >= beta) {
+            bound = TT_BOUND_LOWER;
+        }
+        storeTranspositionTable(state.table, tableKey, depth, bestValue, bound, transformSquare(bestMove, symmetry));
+    }
+
+    return bestValue;
+}
+
+int negamax(SearchPosition &node, int depth, int alpha, int beta, SearchState &state)
+{
+    if (node.player == PLAYER_BLACK) {
+        return searchNode<PLAYER_BLACK>(node, depth, alpha, beta, state);
+    } else {
+        return searchNode<PLAYER_WHITE>(node, depth, alpha, beta, state);
+    }
+}
+
+double getBranchingFactor(SearchStats &stats)
+{
+    if (!stats.iterationCount) {
+        return 0;
+    }
+
+    // Con la tabla llena de la jugada anterior, las primeras iteraciones
+    // casi no buscan: se comparan los nodos de todas con la profundidad final
+    uint64_t nodes = 0;
+    for (int i = 0; i < stats.iterationCount; i++) {
+        nodes += stats.iterations[i].nodes;
+    }
+
+    return pow((double)nodes, 1.0 / stats.iterations[stats.iterationCount - 1].depth);
+}
+
+bool getPredictedMove(GameModel &model, Square &move)
+{
+    TRACE_SCOPE("getPredictedMove");
+
+    Position position = getPosition(model);
+    Player player = getCurrentPlayer(model);
+
+    int symmetry;
+    uint64_t tableKey = getTableKey(position, player, getHashKey(position, player), symmetry);
+
+    TTEntry entry;
+    if (!probeTranspositionTable(getSharedTranspositionTable(), tableKey, entry) ||
+        (entry.move == TT_NO_MOVE))
+        return false;
+
+    // Una colisión de claves podría dar una jugada que no es válida aquí
+    int square = untransformSquare(entry.move, symmetry);
+    if (!(getMobility(position.player, position.opponent) & (1ULL << square)))
+        return false;
+
+    move = getIndexSquare(square);
+
+    return true;
+}
+
+bool gameIsOver(GameModel& model){
+
+    Position position = getPosition(model);
+
+    return isPositionFull(position);
+
+}
+
+int evaluateBoard(GameModel& model, Player currentPlayer){
+    int white = getScore(model, PLAYER_WHITE);
+    int black = getScore(model, PLAYER_BLACK);
+
     if(currentPlayer == PLAYER_BLACK)
     {
         return black - white;
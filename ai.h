@@ -8,7 +8,151 @@
 #ifndef AI_H
 #define AI_H
 
+#include <atomic>
+
 #include "model.h"
+#include "ordering.h"
+#include "pattern.h"
+#include "transposition.h"
+
+/**
+ * @brief A position being searched, with its colour and hash key.
+ */
+struct SearchPosition
+{
+    Position position;
+    Player player;
+    uint64_t hashKey;
+    PatternIndices patterns;
+};
+
+/**
+ * @brief The evaluation functions of the search.
+ */
+enum Evaluator
+{
+    EVALUATOR_DISCS,     // Diferencia de fichas
+    EVALUATOR_HEURISTIC, // Movilidad, frontera, esquinas y casillas X y C
+    EVALUATOR_PATTERNS,  // Pesos entrenados (sin archivo, la heurística)
+};
+
+/**
+ * @brief How the threads of a search share the work.
+ */
+enum ParallelSearch
+{
+    PARALLEL_LAZY_SMP,   // Todos buscan la misma posición y comparten la tabla
+    PARALLEL_ROOT_SPLIT, // Se reparten las jugadas de la raíz en cada iteración
+};
+
+/**
+ * @brief Limits for the AI's search.
+ */
+struct SearchLimits
+{
+    int maxDepth;      // Profundidad máxima, en jugadas
+    uint64_t maxNodes; // Nodos por jugada y por hilo (0: sin límite)
+    double gameTime;   // Tiempo de reloj por jugador, en segundos
+    int threadCount;   // Hilos de búsqueda
+    ParallelSearch parallelSearch;
+
+    // Si no es nulo, otro hilo puede detener la búsqueda con este flag.
+    // La búsqueda también lo activa al terminar
+    std::atomic<bool> *stop;
+
+    // Si no es nulo, el tiempo de la jugada se cuenta desde este momento,
+    // que otro hilo puede fijar más tarde. Con HUGE_VAL se busca sin límite
+    // de tiempo, como al pensar durante el turno del rival
+    std::atomic<double> *startTime;
+
+    int endgameEmpties; // Casillas vacías desde las que se resuelve el final
+    Evaluator evaluator;
+    bool useBook; // Jugar del libro de aperturas, si hay uno cargado
+
+    // Si no es nulo, el estado del generador que elige entre las jugadas del
+    // libro: con el mismo estado se repiten las elecciones
+    uint64_t *bookSeed;
+
+    // Si no es nula, la tabla de transposición de la búsqueda en vez de la
+    // compartida, como la de cada motor de edaversi_match
+    TranspositionTable *table;
+};
+
+/**
+ * @brief What one iteration of the iterative deepening searched.
+ */
+struct SearchIterationStats
+{
+    int depth;
+    uint64_t nodes;
+    uint64_t leaves;
+    double time; // En segundos
+};
+
+/**
+ * @brief Counters of a search, kept per thread and added up at the end.
+ */
+struct SearchStats
+{
+    // Evaluaciones, posiciones finales y finales de pocas casillas que se
+    // resuelven de una vez
+    uint64_t leaves;
+    uint64_t expandedNodes;    // Nodos cuyas jugadas se recorrieron
+    uint64_t betaCutoffs;      // Nodos expandidos que podaron
+    uint64_t firstMoveCutoffs; // Podas con la primera jugada
+    uint64_t ttProbes;
+    uint64_t ttHits;
+    uint64_t ttCutoffs; // Consultas que resolvieron el nodo
+
+    // Iteraciones completas del hilo principal
+    int iterationCount;
+    SearchIterationStats iterations[BOARD_SIZE * BOARD_SIZE + 1];
+};
+
+/**
+ * @brief The state of a running search.
+ */
+struct SearchState
+{
+    uint64_t nodes;
+    uint64_t maxNodes;
+    std::atomic<double> *startTime; // Compartido por los hilos de una búsqueda
+    double hardTime;
+    int endgameEmpties;
+    Evaluator evaluator;
+    bool aborted;
+    std::atomic<bool> *stop; // Compartido por los hilos de una búsqueda
+    TranspositionTable *table;
+
+    // Con PARALLEL_ROOT_SPLIT, los estados de los hilos entre los que el
+    // hilo principal reparte las jugadas de la raíz (el primero es el suyo)
+    SearchState *splitStates;
+    int splitCount;
+
+    MoveOrdering ordering;
+    SearchStats stats;
+};
+
+/**
+ * @brief What a search found.
+ */
+struct SearchInfo
+{
+    int depth;      // Última profundidad completa
+    int score;      // Valor de la mejor jugada a esa profundidad
+    uint64_t nodes; // Nodos de todos los hilos
+    double time;    // Duración, en segundos
+    bool book;      // La jugada salió del libro de aperturas
+
+    SearchStats stats; // Contadores de todos los hilos
+};
+
+/**
+ * @brief Initializes search limits to the AI's defaults.
+ *
+ * @param limits The search limits.
+ */
+void initSearchLimits(SearchLimits &limits);
 
 /**
  * @brief Returns the best move for a certain position.
@@ -17,11 +161,90 @@
  */
 Square getBestMove(GameModel &model);
 
+/**
+ * @brief Returns the best move for a certain position, within some limits.
+ *
+ * Searches with iterative deepening until the time budget for the move
+ * runs out and returns the best move of the last completed depth.
+ *
+ * @param model The game model.
+ * @param limits The search limits.
+ * @return The best move.
+ */
+Square getBestMove(GameModel &model, SearchLimits &limits);
+
+/**
+ * @brief Returns the best move for a certain position, within some limits.
+ *
+ * With several threads and PARALLEL_LAZY_SMP, helper threads search the
+ * same position and share their results through the transposition table;
+ * the move comes from the main thread. With PARALLEL_ROOT_SPLIT, each
+ * iteration splits the root moves between the threads instead, so a
+ * search to a fixed depth picks the same move with any thread count.
+ *
+ * @param model The game model.
+ * @param limits The search limits.
+ * @param info Receives what the search found.
+ * @return The best move.
+ */
+Square getBestMove(GameModel &model, SearchLimits &limits, SearchInfo &info);
+
+/**
+ * @brief Returns the move the shared transposition table expects for a position.
+ *
+ * After the AI moves, this predicts the opponent's reply from the
+ * AI's principal variation.
+ *
+ * @param model The game model.
+ * @param move Receives the move, if any.
+ * @return A move was found.
+ */
+bool getPredictedMove(GameModel &model, Square &move);
+
+/**
+ * @brief Returns the effective branching factor of a search.
+ *
+ * The number whose power to the depth of the last completed iteration
+ * is the number of nodes the main thread searched up to it.
+ *
+ * @param stats The search counters.
+ * @return The branching factor, or 0 without completed iterations.
+ */
+double getBranchingFactor(SearchStats &stats);
+
 bool gameIsOver(GameModel& model);
 
 int evaluateBoard(GameModel& model, Player currentPlayer);
 
-int minimax(GameModel &model, int depth, bool maximizingPlayer, int alpha, int beta, int &nodosEvaluados, int maxNodos);
+/**
+ * @brief Searches a position with negamax principal variation search.
+ *
+ * @param node The search position.
+ * @param depth The remaining depth, in moves (passes are free).
+ * @param alpha The lower bound of the window.
+ * @param beta The upper bound of the window.
+ * @param state The search state.
+ * @return The score, from the side to move's point of view.
+ */
+int negamax(SearchPosition &node, int depth, int alpha, int beta, SearchState &state);
+
+/**
+ * @brief Counts a search node and checks the search's time and node limits.
+ *
+ * @param state The search state.
+ * @return The search must stop.
+ */
+bool isSearchAborted(SearchState &state);
+
+/**
+ * @brief Returns the final disc difference of a finished game.
+ *
+ * The empty squares count for the winner.
+ *
+ * @param position The position.
+ * @return The score, from the side to move's point of view.
+ */
+int getFinalScore(Position &position);
 
 
 #endif
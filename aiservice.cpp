@@ -0,0 +1,261 @@
+/**
+ * @brief Runs the AI's search on a background thread
+ *
+ * @copyright Copyright (c) 2023-2024
+ */
+
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <thread>
+
+#include "ai.h"
+#include "aiservice.h"
+#include "trace.h"
+
+// Valor del resultado mientras la búsqueda no terminó
+#define SEARCH_PENDING -1
+
+/**
+ * @brief The background search.
+ *
+ * Only the search thread writes the result, and only once: the index of
+ * the move, published with release ordering. The rest belongs to the
+ * thread that calls the service.
+ */
+static struct BestMoveSearch
+{
+    std::thread thread;
+    std::atomic<bool> stop;
+    std::atomic<double> startTime;
+    std::atomic<int> result;
+    SearchInfo info; // Se escribe antes de publicar el resultado
+    bool running = false;
+    bool pondering = false;
+
+    // La última búsqueda que terminó con una jugada
+    SearchInfo lastInfo;
+    bool hasLastInfo = false;
+    FILE *log = nullptr;
+
+    // La posición sobre la que se piensa
+    Bitboard discs[2];
+    Player currentPlayer;
+
+    ~BestMoveSearch()
+    {
+        stop = true;
+        if (thread.joinable())
+            thread.join();
+        if (log)
+            fclose(log);
+    }
+} bestMoveSearch;
+
+/**
+ * @brief Searches a model snapshot and publishes the best move.
+ *
+ * @param model The model snapshot.
+ */
+static void runBestMoveSearch(GameModel model)
+{
+    TRACE_THREAD_NAME("search");
+    TRACE_SCOPE("runBestMoveSearch");
+
+    SearchLimits limits;
+    initSearchLimits(limits);
+    limits.stop = &bestMoveSearch.stop;
+    limits.startTime = &bestMoveSearch.startTime;
+
+    Square move = getBestMove(model, limits, bestMoveSearch.info);
+
+    bestMoveSearch.result.store(getSquareIndex(move), std::memory_order_release);
+}
+
+/**
+ * @brief Writes a search's statistics as one JSON line to the search log.
+ *
+ * @param move The move the search found.
+ * @param info What the search found.
+ */
+static void writeSearchLog(Square move, SearchInfo &info)
+{
+    SearchStats &stats = info.stats;
+    Bitboard discs = bestMoveSearch.discs[PLAYER_BLACK] | bestMoveSearch.discs[PLAYER_WHITE];
+
+    fprintf(bestMoveSearch.log,
+            "{\"ply\": %d, \"player\": \"%s\", \"move\": \"%c%d\", \"book\": %s, "
+            "\"depth\": %d, \"score\": %d, \"nodes\": %llu, \"time\": %.6f, \"nps\": %.0f, "
+            "\"leaves\": %llu, \"betaCutoffRate\": %.4f, \"firstMoveCutoffRate\": %.4f, "
+            "\"branchingFactor\": %.3f, \"ttProbes\": %llu, \"ttHitRate\": %.4f, "
+            "\"ttCutoffRate\": %.4f, \"iterations\": [",
+            countBits(discs) - 4,
+            (bestMoveSearch.currentPlayer == PLAYER_BLACK) ? "black" : "white",
+            'a' + move.x,
+            move.y + 1,
+            info.book ? "true" : "false",
+            info.depth,
+            info.score,
+            (unsigned long long)info.nodes,
+            info.time,
+            info.time ? info.nodes / info.time : 0.0,
+            (unsigned long long)stats.leaves,
+            stats.expandedNodes ? (double)stats.betaCutoffs / stats.expandedNodes : 0.0,
+            stats.betaCutoffs ? (double)stats.firstMoveCutoffs / stats.betaCutoffs : 0.0,
+            getBranchingFactor(stats),
+            (unsigned long long)stats.ttProbes,
+            stats.ttProbes ? (double)stats.ttHits / stats.ttProbes : 0.0,
+            stats.ttProbes ? (double)stats.ttCutoffs / stats.ttProbes : 0.0);
+
+    for (int i = 0; i < stats.iterationCount; i++)
+    {
+        SearchIterationStats &iteration = stats.iterations[i];
+
+        fprintf(bestMoveSearch.log,
+                "%s{\"depth\": %d, \"nodes\": %llu, \"leaves\": %llu, \"time\": %.6f}",
+                i ? ", " : "",
+                iteration.depth,
+                (unsigned long long)iteration.nodes,
+                (unsigned long long)iteration.leaves,
+                iteration.time);
+    }
+
+    fprintf(bestMoveSearch.log, "]}\n");
+    fflush(bestMoveSearch.log);
+}
+
+/**
+ * @brief Starts a background search on a model snapshot.
+ *
+ * @param model The game model.
+ * @param ponder Search without a time limit until ponderHitBestMoveSearch.
+ */
+static void startSearch(GameModel &model, bool ponder)
+{
+    stopBestMoveSearch();
+
+    bestMoveSearch.stop = false;
+    bestMoveSearch.startTime = ponder ? HUGE_VAL : getClockTime();
+    bestMoveSearch.result = SEARCH_PENDING;
+    bestMoveSearch.running = true;
+    bestMoveSearch.pondering = ponder;
+    bestMoveSearch.discs[PLAYER_BLACK] = model.discs[PLAYER_BLACK];
+    bestMoveSearch.discs[PLAYER_WHITE] = model.discs[PLAYER_WHITE];
+    bestMoveSearch.currentPlayer = model.currentPlayer;
+
+    // Si el juego terminó no hay nada que buscar, pero la búsqueda igual
+    // queda marcada, para no intentarlo de nuevo en cada cuadro
+    if (model.gameOver)
+        return;
+
+    bestMoveSearch.thread = std::thread(runBestMoveSearch, model);
+}
+
+void startBestMoveSearch(GameModel &model)
+{
+    startSearch(model, false);
+}
+
+void startPonderSearch(GameModel &model)
+{
+    GameModel snapshot = model;
+
+    // Se piensa sobre la respuesta esperada del rival, que es la jugada
+    // forzada o la de la variante principal de la búsqueda anterior. Si no
+    // hay ninguna, se piensa sobre la posición actual
+    Moves validMoves;
+    getValidMoves(snapshot, validMoves);
+
+    Square predictedMove;
+    if (validMoves.size() == 1)
+        playMove(snapshot, validMoves[0]);
+    else if (getPredictedMove(snapshot, predictedMove))
+        playMove(snapshot, predictedMove);
+
+    startSearch(snapshot, true);
+}
+
+bool ponderHitBestMoveSearch(GameModel &model)
+{
+    if (!isPonderSearchRunning() ||
+        (model.discs[PLAYER_BLACK] != bestMoveSearch.discs[PLAYER_BLACK]) ||
+        (model.discs[PLAYER_WHITE] != bestMoveSearch.discs[PLAYER_WHITE]) ||
+        (model.currentPlayer != bestMoveSearch.currentPlayer))
+        return false;
+
+    // Desde ahora corre el reloj de la jugada
+    TRACE_EVENT("ponderHit");
+    bestMoveSearch.startTime = getClockTime();
+    bestMoveSearch.pondering = false;
+
+    return true;
+}
+
+bool isBestMoveSearchRunning()
+{
+    return bestMoveSearch.running;
+}
+
+bool isPonderSearchRunning()
+{
+    return bestMoveSearch.running && bestMoveSearch.pondering;
+}
+
+bool pollBestMoveSearch(Square &move)
+{
+    if (!bestMoveSearch.running || bestMoveSearch.pondering)
+        return false;
+
+    int result = bestMoveSearch.result.load(std::memory_order_acquire);
+    if (result == SEARCH_PENDING)
+        return false;
+
+    bestMoveSearch.thread.join();
+    bestMoveSearch.running = false;
+
+    move = getIndexSquare(result);
+
+    bestMoveSearch.lastInfo = bestMoveSearch.info;
+    bestMoveSearch.hasLastInfo = true;
+    if (bestMoveSearch.log)
+        writeSearchLog(move, bestMoveSearch.lastInfo);
+
+    return true;
+}
+
+bool getLastSearchInfo(SearchInfo &info)
+{
+    if (!bestMoveSearch.hasLastInfo)
+        return false;
+
+    info = bestMoveSearch.lastInfo;
+
+    return true;
+}
+
+bool openSearchLog(const char *path)
+{
+    closeSearchLog();
+    bestMoveSearch.log = fopen(path, "a");
+
+    return bestMoveSearch.log != nullptr;
+}
+
+void closeSearchLog()
+{
+    if (bestMoveSearch.log)
+        fclose(bestMoveSearch.log);
+    bestMoveSearch.log = nullptr;
+}
+
+void stopBestMoveSearch()
+{
+    TRACE_SCOPE("stopBestMoveSearch");
+
+    bestMoveSearch.stop = true;
+    if (bestMoveSearch.thread.joinable())
+        bestMoveSearch.thread.join();
+
+    bestMoveSearch.running = false;
+    bestMoveSearch.pondering = false;
+}
@@ -0,0 +1,100 @@
+/**
+ * @brief Runs the AI's search on a background thread
+ *
+ * @copyright Copyright (c) 2023-2024
+ */
+
+#ifndef AISERVICE_H
+#define AISERVICE_H
+
+#include "ai.h"
+#include "model.h"
+
+/**
+ * @brief Starts searching the best move for a position on a background thread.
+ *
+ * The search works on a copy of the model, so the caller can keep
+ * reading (and drawing) the model while it runs.
+ *
+ * @param model The game model.
+ */
+void startBestMoveSearch(GameModel &model);
+
+/**
+ * @brief Starts pondering a position on a background thread.
+ *
+ * Searches the position after the opponent's expected reply (or the
+ * position itself, if there is no prediction) without a time limit
+ * while the opponent thinks. If the opponent plays the expected move,
+ * ponderHitBestMoveSearch turns it into the AI's search; otherwise the
+ * transposition table is at least warm for the next search.
+ *
+ * @param model The game model, with the opponent to move.
+ */
+void startPonderSearch(GameModel &model);
+
+/**
+ * @brief Turns the running ponder search into the search of a position.
+ *
+ * Succeeds when the search is pondering this same position. The
+ * search then keeps its work and starts its clock now.
+ *
+ * @param model The game model, with the AI to move.
+ * @return The ponder search continues as the position's search.
+ */
+bool ponderHitBestMoveSearch(GameModel &model);
+
+/**
+ * @brief Checks whether a search was started and its move not yet taken.
+ *
+ * @return true or false.
+ */
+bool isBestMoveSearchRunning();
+
+/**
+ * @brief Checks whether the running search is pondering.
+ *
+ * @return true or false.
+ */
+bool isPonderSearchRunning();
+
+/**
+ * @brief Takes the move of a finished search. Does not block.
+ *
+ * Pondering searches never return a move.
+ *
+ * @param move Receives the best move, if the search finished.
+ * @return Search finished.
+ */
+bool pollBestMoveSearch(Square &move);
+
+/**
+ * @brief Stops the running search, if any, and discards its move.
+ */
+void stopBestMoveSearch();
+
+/**
+ * @brief Returns what the last search whose move was taken found.
+ *
+ * @param info Receives the search information, if any.
+ * @return There was such a search.
+ */
+bool getLastSearchInfo(SearchInfo &info);
+
+/**
+ * @brief Opens the search log, which receives one JSON line per AI move.
+ *
+ * Each line holds the move, the search's result and its statistics.
+ * Lines are appended to the file.
+ *
+ * @param path The path of the log file.
+ * @return The file could be opened.
+ */
+bool openSearchLog(const char *path);
+
+/**
+ * @brief Closes the search log, if open.
+ */
+void closeSearchLog();
+
+#endif
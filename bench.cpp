@@ -0,0 +1,352 @@
+/**
+ * @brief Measures the model and AI primitives
+ *
+ * Usage: edaversi_bench [-json] [-time seconds] [-depth plies] [-kernel scalar|avx2]
+ *
+ * Times getValidMoves, playMove, getFlips, evaluateBoard, gameIsOver and
+ * getScore over a fixed set of midgame and endgame positions, and reports
+ * the time and heap allocations per call. Also times a one-thread
+ * getBestMove at a fixed depth (6, or -depth) on the midgame positions,
+ * and reports its time and heap allocations per search node, so that
+ * changes to the search, move ordering, table or evaluator show. With -json, prints one JSON
+ * object instead of a table. With -kernel, flips are computed with that
+ * kernel instead of the fastest one the CPU supports. Built without
+ * sanitizers and at full optimization.
+ *
+ * @copyright Copyright (c) 2023-2024
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <vector>
+
+#include "ai.h"
+#include "transposition.h"
+
+#define DEFAULT_TIME 0.5
+#define GAME_COUNT 16
+// Jugadas al azar al principio de cada partida
+#define RANDOM_PLIES 8
+#define CORPUS_SEARCH_DEPTH 2
+// Búsqueda medida por nodo
+#define DEFAULT_SEARCH_DEPTH 6
+#define SEARCH_TABLE_BITS 16
+
+// Jugadas tras las que se guarda la posición de cada partida
+static const int corpusPlies[] = {20, 28, 36, 44, 50, 54};
+// Desde aquí las posiciones son de final
+#define ENDGAME_PLY 44
+
+/**
+ * @brief A corpus position, with the move played from it in its game.
+ */
+struct CorpusPosition
+{
+    GameModel model;
+    Square move;
+};
+
+/**
+ * @brief A timed primitive.
+ */
+struct Benchmark
+{
+    const char *name;
+    const char *corpus; // "midgame", "endgame" o "all"
+    double nsPerOp;
+    double allocsPerOp;
+    uint64_t ops;
+};
+
+// Reservas de memoria dinámica de todo el programa
+static uint64_t allocationCount;
+
+void *operator new(size_t size)
+{
+    allocationCount++;
+
+    void *pointer = malloc(size ? size : 1);
+    if (!pointer)
+        throw std::bad_alloc();
+
+    return pointer;
+}
+
+void operator delete(void *pointer) noexcept
+{
+    free(pointer);
+}
+
+void operator delete(void *pointer, size_t) noexcept
+{
+    free(pointer);
+}
+
+// Evita que el compilador descarte los resultados
+static volatile int sink;
+
+/**
+ * @brief Plays the corpus games and collects their positions.
+ *
+ * Each game starts with random moves and continues with a shallow
+ * heuristic search, so that positions look like real games.
+ *
+ * @param midgame Receives the midgame positions.
+ * @param endgame Receives the endgame positions.
+ */
+static void buildCorpus(std::vector<CorpusPosition> &midgame, std::vector<CorpusPosition> &endgame)
+{
+    SearchLimits limits;
+    initSearchLimits(limits);
+    limits.maxDepth = CORPUS_SEARCH_DEPTH;
+    limits.gameTime = 1e9;
+    limits.threadCount = 1;
+    limits.endgameEmpties = 0;
+    limits.evaluator = EVALUATOR_HEURISTIC;
+    limits.useBook = false;
+
+    uint64_t seed = 1;
+    for (int game = 0; game < GAME_COUNT; game++)
+    {
+        GameModel model;
+        initModel(model);
+        startModel(model);
+
+        size_t nextPly = 0;
+        for (int ply = 0; !model.gameOver && (nextPly < sizeof(corpusPlies) / sizeof(corpusPlies[0])); ply++)
+        {
+            Square move;
+            if (ply < RANDOM_PLIES)
+            {
+                Moves validMoves;
+                getValidMoves(model, validMoves);
+
+                seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+                move = validMoves[(int)((seed >> 33) % validMoves.size())];
+            }
+            else
+                move = getBestMove(model, limits);
+
+            if (ply == corpusPlies[nextPly])
+            {
+                (ply < ENDGAME_PLY ? midgame : endgame).push_back({model, move});
+                nextPly++;
+            }
+
+            playMove(model, move);
+        }
+    }
+}
+
+/**
+ * @brief Times a primitive over some positions.
+ *
+ * Repeats passes over the positions until the given time runs out.
+ *
+ * @param benchmark Receives the results.
+ * @param positions The positions.
+ * @param minTime The time to measure for, in seconds.
+ * @param function Calls the primitive once on a position.
+ */
+template <typename Function>
+static void runBenchmark(Benchmark &benchmark, std::vector<CorpusPosition> &positions, double minTime, Function function)
+{
+    // Una pasada previa calienta las cachés
+    for (CorpusPosition &position : positions)
+        function(position);
+
+    uint64_t ops = 0;
+    uint64_t allocations = allocationCount;
+    double startTime = getClockTime();
+    double time;
+    do
+    {
+        for (int i = 0; i < 64; i++)
+        {
+            for (CorpusPosition &position : positions)
+                function(position);
+        }
+        ops += 64 * positions.size();
+        time = getClockTime() - startTime;
+    } while (time < minTime);
+
+    benchmark.ops = ops;
+    benchmark.nsPerOp = time * 1e9 / ops;
+    benchmark.allocsPerOp = (double)(allocationCount - allocations) / ops;
+}
+
+/**
+ * @brief Times getBestMove over some positions, per search node.
+ *
+ * Searches with one thread to a fixed depth. Each search starts with an
+ * empty table, so every pass visits the same nodes; clearing the table
+ * is not timed.
+ *
+ * @param benchmark Receives the results.
+ * @param positions The positions.
+ * @param minTime The time to measure for, in seconds.
+ * @param depth The search depth.
+ */
+static void runSearchBenchmark(Benchmark &benchmark,
+                               std::vector<CorpusPosition> &positions,
+                               double minTime,
+                               int depth)
+{
+    SearchLimits limits;
+    initSearchLimits(limits);
+    limits.maxDepth = depth;
+    limits.gameTime = 1e9;
+    limits.threadCount = 1;
+    limits.useBook = false;
+    limits.table = createTranspositionTable(SEARCH_TABLE_BITS);
+
+    uint64_t nodes = 0;
+    uint64_t allocations = 0;
+    double time = 0;
+    // La primera pasada calienta las cachés y no se cuenta
+    for (int pass = 0; !pass || (time < minTime); pass++)
+    {
+        for (CorpusPosition &position : positions)
+        {
+            clearTranspositionTable(limits.table);
+
+            SearchInfo info;
+            uint64_t startAllocations = allocationCount;
+            double startTime = getClockTime();
+            getBestMove(position.model, limits, info);
+            if (!pass)
+                continue;
+
+            time += getClockTime() - startTime;
+            allocations += allocationCount - startAllocations;
+            nodes += info.nodes;
+        }
+    }
+
+    freeTranspositionTable(limits.table);
+
+    benchmark.ops = nodes;
+    benchmark.nsPerOp = time * 1e9 / nodes;
+    benchmark.allocsPerOp = (double)allocations / nodes;
+}
+
+int main(int argc, char *argv[])
+{
+    bool json = false;
+    double minTime = DEFAULT_TIME;
+    int searchDepth = DEFAULT_SEARCH_DEPTH;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "-json"))
+            json = true;
+        else if (!strcmp(argv[i], "-time") && (i + 1 < argc))
+            minTime = atof(argv[++i]);
+        else if (!strcmp(argv[i], "-depth") && (i + 1 < argc))
+            searchDepth = std::max(atoi(argv[++i]), 1);
+        else if (!strcmp(argv[i], "-kernel") && (i + 1 < argc))
+        {
+            i++;
+            FlipKernel kernel = !strcmp(argv[i], "avx2") ? FLIP_KERNEL_AVX2 : FLIP_KERNEL_SCALAR;
+            if ((strcmp(argv[i], "scalar") && strcmp(argv[i], "avx2")) || !setFlipKernel(kernel))
+            {
+                fprintf(stderr, "Flip kernel not available: %s\n", argv[i]);
+                return 1;
+            }
+        }
+        else
+        {
+            fprintf(stderr, "Invalid option: %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    std::vector<CorpusPosition> midgame;
+    std::vector<CorpusPosition> endgame;
+    buildCorpus(midgame, endgame);
+
+    std::vector<CorpusPosition> all = midgame;
+    all.insert(all.end(), endgame.begin(), endgame.end());
+
+    std::vector<Benchmark> benchmarks;
+    auto add = [&](const char *name, const char *corpus) -> Benchmark & {
+        benchmarks.push_back({name, corpus, 0, 0, 0});
+        return benchmarks.back();
+    };
+
+    auto validMoves = [](CorpusPosition &position) {
+        Moves validMoves;
+        getValidMoves(position.model, validMoves);
+        sink = validMoves.size();
+    };
+    runBenchmark(add("getValidMoves", "midgame"), midgame, minTime, validMoves);
+    runBenchmark(add("getValidMoves", "endgame"), endgame, minTime, validMoves);
+
+    // Cada llamada juega sobre una copia, que se cuenta en el tiempo
+    auto move = [](CorpusPosition &position) {
+        GameModel child = position.model;
+        playMove(child, position.move);
+        sink = child.currentPlayer;
+    };
+    runBenchmark(add("playMove", "midgame"), midgame, minTime, move);
+    runBenchmark(add("playMove", "endgame"), endgame, minTime, move);
+
+    auto flips = [](CorpusPosition &position) {
+        Position board = getPosition(position.model);
+        sink = (int)getFlips(board.player, board.opponent, getSquareIndex(position.move));
+    };
+    runBenchmark(add("getFlips", "midgame"), midgame, minTime, flips);
+    runBenchmark(add("getFlips", "endgame"), endgame, minTime, flips);
+
+    runBenchmark(add("evaluateBoard", "all"), all, minTime, [](CorpusPosition &position) {
+        sink = evaluateBoard(position.model, position.model.currentPlayer);
+    });
+    runBenchmark(add("gameIsOver", "all"), all, minTime, [](CorpusPosition &position) {
+        sink = gameIsOver(position.model);
+    });
+    runBenchmark(add("getScore", "all"), all, minTime, [](CorpusPosition &position) {
+        sink = getScore(position.model, position.model.currentPlayer);
+    });
+
+    // Por nodo: el tiempo y las reservas de una búsqueda entera, entre sus nodos
+    runSearchBenchmark(add("getBestMove/node", "midgame"), midgame, minTime, searchDepth);
+
+    if (json)
+    {
+        printf("{\"midgamePositions\": %zu, \"endgamePositions\": %zu, \"searchDepth\": %d, \"benchmarks\": [",
+               midgame.size(),
+               endgame.size(),
+               searchDepth);
+        for (size_t i = 0; i < benchmarks.size(); i++)
+        {
+            Benchmark &benchmark = benchmarks[i];
+            printf("%s\n  {\"name\": \"%s\", \"corpus\": \"%s\", \"ops\": %llu, \"nsPerOp\": %.3f, \"allocsPerOp\": %.6f}",
+                   i ? "," : "",
+                   benchmark.name,
+                   benchmark.corpus,
+                   (unsigned long long)benchmark.ops,
+                   benchmark.nsPerOp,
+                   benchmark.allocsPerOp);
+        }
+        printf("\n]}\n");
+    }
+    else
+    {
+        printf("%zu midgame and %zu endgame positions, search depth %d\n\n",
+               midgame.size(),
+               endgame.size(),
+               searchDepth);
+        printf("%-24s %-8s %10s %10s\n", "primitive", "corpus", "ns/op", "allocs/op");
+        for (Benchmark &benchmark : benchmarks)
+            printf("%-24s %-8s %10.1f %10.4f\n",
+                   benchmark.name,
+                   benchmark.corpus,
+                   benchmark.nsPerOp,
+                   benchmark.allocsPerOp);
+    }
+
+    return 0;
+}
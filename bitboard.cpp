@@ -0,0 +1,397 @@
+/**
+ * @brief Implements bitboard move generation
+ *
+ * @copyright Copyright (c) 2023-2024
+ */
+
+#ifdef EDAVERSI_AVX2
+#include <immintrin.h>
+#endif
+
+#include "bitboard.h"
+
+// Casillas fuera de la columna x = 0 y x = 7
+#define NOT_FIRST_COLUMN 0xfefefefefefefefeULL
+#define NOT_LAST_COLUMN 0x7f7f7f7f7f7f7f7fULL
+// Casillas fuera de ambas columnas de los bordes
+#define INNER_COLUMNS 0x7e7e7e7e7e7e7e7eULL
+
+#define DIRECTION_COUNT 8
+
+/**
+ * @brief Moves every square of a bitboard one step in a direction.
+ *
+ * Squares that would wrap around the board edge are discarded.
+ *
+ * @param bitboard The bitboard.
+ * @param direction The direction (0 to 7).
+ * @return The shifted bitboard.
+ */
+static inline Bitboard shift(Bitboard bitboard, int direction)
+{
+    switch (direction)
+    {
+    case 0: // derecha
+        return (bitboard << 1) & NOT_FIRST_COLUMN;
+    case 1: // izquierda
+        return (bitboard >> 1) & NOT_LAST_COLUMN;
+    case 2: // abajo
+        return bitboard << 8;
+    case 3: // arriba
+        return bitboard >> 8;
+    case 4: // abajo a la derecha
+        return (bitboard << 9) & NOT_FIRST_COLUMN;
+    case 5: // abajo a la izquierda
+        return (bitboard << 7) & NOT_LAST_COLUMN;
+    case 6: // arriba a la derecha
+        return (bitboard >> 7) & NOT_FIRST_COLUMN;
+    default: // arriba a la izquierda
+        return (bitboard >> 9) & NOT_LAST_COLUMN;
+    }
+}
+
+Bitboard getMobility(Bitboard player, Bitboard opponent)
+{
+    Bitboard empty = ~(player | opponent);
+    Bitboard moves = 0;
+
+    for (int direction = 0; direction < DIRECTION_COUNT; direction++)
+    {
+        // Fichas rivales alineadas con una propia (a lo sumo 6 seguidas)
+        Bitboard line = shift(player, direction) & opponent;
+        line |= shift(line, direction) & opponent;
+        line |= shift(line, direction) & opponent;
+        line |= shift(line, direction) & opponent;
+        line |= shift(line, direction) & opponent;
+        line |= shift(line, direction) & opponent;
+
+        moves |= shift(line, direction) & empty;
+    }
+
+    return moves;
+}
+
+Bitboard getNeighbours(Bitboard bitboard)
+{
+    // Primero a los costados, después arriba y abajo de la fila ensanchada
+    Bitboard row = bitboard | shift(bitboard, 0) | shift(bitboard, 1);
+
+    return (row | (row << 8) | (row >> 8)) & ~bitboard;
+}
+
+/*
+ * Flips are computed with a parallel-prefix fill from the move square
+ * over the opponent's discs, one fill per direction. Horizontal and
+ * diagonal fills only run over the inner columns so they cannot wrap
+ * around the board edge. A direction flips its fill when the square
+ * following it holds one of the player's discs.
+ *
+ * The AVX2 kernel runs the four left shifts (1, 8, 9, 7) in one register
+ * and the four right shifts in another.
+ *
+ * The scalar kernel works on the four lines through the move instead:
+ * each line is gathered into a byte (a shift for rows, a multiplication
+ * for columns and diagonals), two lookups give its flipped discs, and
+ * the byte is spread back over the line. The tables are built at
+ * compile time. Both kernels return identical results.
+ *
+ * Only the AVX2 kernel is built for AVX2, so one binary runs on any x86
+ * CPU: getFlips picks the kernel the CPU supports when the program starts.
+ */
+#ifdef EDAVERSI_AVX2
+
+/**
+ * @brief Returns the discs flipped by a move, with AVX2.
+ *
+ * @param player The discs of the side to move.
+ * @param opponent The discs of the opponent.
+ * @param square The square index of the move.
+ * @return The flipped discs.
+ */
+__attribute__((target("avx2"))) static Bitboard getFlipsAVX2(Bitboard player, Bitboard opponent, int square)
+{
+    const __m256i shifts = _mm256_set_epi64x(7, 9, 8, 1);
+    const __m256i shifts2 = _mm256_set_epi64x(14, 18, 16, 2);
+    const __m256i masks = _mm256_set_epi64x(INNER_COLUMNS, INNER_COLUMNS, -1, INNER_COLUMNS);
+
+    __m256i move = _mm256_set1_epi64x(1ULL << square);
+    __m256i own = _mm256_set1_epi64x(player);
+    __m256i mask = _mm256_and_si256(_mm256_set1_epi64x(opponent), masks);
+
+    // Hacia índices mayores
+    __m256i prefix = _mm256_and_si256(mask, _mm256_sllv_epi64(mask, shifts));
+    __m256i left = _mm256_and_si256(mask, _mm256_sllv_epi64(move, shifts));
+    left = _mm256_or_si256(left, _mm256_and_si256(mask, _mm256_sllv_epi64(left, shifts)));
+    left = _mm256_or_si256(left, _mm256_and_si256(prefix, _mm256_sllv_epi64(left, shifts2)));
+    left = _mm256_or_si256(left, _mm256_and_si256(prefix, _mm256_sllv_epi64(left, shifts2)));
+    __m256i leftEnd = _mm256_and_si256(own, _mm256_sllv_epi64(left, shifts));
+
+    // Hacia índices menores
+    prefix = _mm256_and_si256(mask, _mm256_srlv_epi64(mask, shifts));
+    __m256i right = _mm256_and_si256(mask, _mm256_srlv_epi64(move, shifts));
+    right = _mm256_or_si256(right, _mm256_and_si256(mask, _mm256_srlv_epi64(right, shifts)));
+    right = _mm256_or_si256(right, _mm256_and_si256(prefix, _mm256_srlv_epi64(right, shifts2)));
+    right = _mm256_or_si256(right, _mm256_and_si256(prefix, _mm256_srlv_epi64(right, shifts2)));
+    __m256i rightEnd = _mm256_and_si256(own, _mm256_srlv_epi64(right, shifts));
+
+    // Descarta las direcciones que no terminan en una ficha propia
+    __m256i zero = _mm256_setzero_si256();
+    left = _mm256_andnot_si256(_mm256_cmpeq_epi64(leftEnd, zero), left);
+    right = _mm256_andnot_si256(_mm256_cmpeq_epi64(rightEnd, zero), right);
+
+    __m256i flips = _mm256_or_si256(left, right);
+    __m128i half = _mm_or_si128(_mm256_castsi256_si128(flips),
+                                _mm256_extracti128_si256(flips, 1));
+
+    return (Bitboard)_mm_cvtsi128_si64(_mm_or_si128(half, _mm_unpackhi_epi64(half, half)));
+}
+
+#endif
+
+// Columna x = 0
+#define FIRST_COLUMN 0x0101010101010101ULL
+// Lleva la columna x = 0 a la fila y = 7, con la casilla de y = i en el bit 56 + i
+#define COLUMN_TO_ROW 0x0102040810204080ULL
+
+/**
+ * @brief Lookup tables for the scalar flip kernel, built at compile time.
+ *
+ * A line is a byte with one bit per square, and a position is a square
+ * of the line.
+ */
+static constexpr struct FlipTables
+{
+    // Línea a1-h8 y línea a8-h1 que pasan por cada casilla
+    Bitboard diagonals[64];
+    Bitboard antidiagonals[64];
+
+    // Casillas en las que terminan las fichas rivales seguidas a cada lado
+    // de una posición, según las fichas rivales de la línea sin sus extremos
+    uint8_t outflanks[8][64];
+
+    // Fichas que se dan vuelta desde una posición, según los extremos propios
+    uint8_t flips[8][256];
+
+    // Columna x = 0 con las casillas de una línea
+    Bitboard columns[256];
+
+    constexpr FlipTables() : diagonals{}, antidiagonals{}, outflanks{}, flips{}, columns{}
+    {
+        for (int square = 0; square < 64; square++)
+        {
+            int x = square % 8;
+            int y = square / 8;
+
+            for (int i = -7; i <= 7; i++)
+            {
+                if ((x + i >= 0) && (x + i < 8) && (y + i >= 0) && (y + i < 8))
+                    diagonals[square] |= 1ULL << (square + 9 * i);
+                if ((x + i >= 0) && (x + i < 8) && (y - i >= 0) && (y - i < 8))
+                    antidiagonals[square] |= 1ULL << (square - 7 * i);
+            }
+        }
+
+        for (int position = 0; position < 8; position++)
+        {
+            for (int inner = 0; inner < 64; inner++)
+            {
+                int opponent = inner << 1;
+
+                int i = position + 1;
+                while ((i < 8) && (opponent & (1 << i)))
+                    i++;
+                if (i < 8)
+                    outflanks[position][inner] |= (uint8_t)(1 << i);
+
+                i = position - 1;
+                while ((i >= 0) && (opponent & (1 << i)))
+                    i--;
+                if (i >= 0)
+                    outflanks[position][inner] |= (uint8_t)(1 << i);
+            }
+
+            for (int outflank = 0; outflank < 256; outflank++)
+            {
+                int i = position + 1;
+                while ((i < 8) && !(outflank & (1 << i)))
+                    i++;
+                for (int j = position + 1; (i < 8) && (j < i); j++)
+                    flips[position][outflank] |= (uint8_t)(1 << j);
+
+                i = position - 1;
+                while ((i >= 0) && !(outflank & (1 << i)))
+                    i--;
+                for (int j = i + 1; (i >= 0) && (j < position); j++)
+                    flips[position][outflank] |= (uint8_t)(1 << j);
+            }
+        }
+
+        for (int line = 0; line < 256; line++)
+        {
+            for (int i = 0; i < 8; i++)
+            {
+                if (line & (1 << i))
+                    columns[line] |= 1ULL << (8 * i);
+            }
+        }
+    }
+} flipTables;
+
+/**
+ * @brief Returns the discs flipped on a line.
+ *
+ * @param position The move's position in the line.
+ * @param player The discs of the side to move on the line.
+ * @param opponent The discs of the opponent on the line.
+ * @return The flipped discs on the line.
+ */
+static inline unsigned getLineFlips(int position, unsigned player, unsigned opponent)
+{
+    // Las fichas rivales de los extremos nunca quedan encerradas
+    unsigned outflank = flipTables.outflanks[position][(opponent >> 1) & 0x3f] & player;
+
+    return flipTables.flips[position][outflank];
+}
+
+/**
+ * @brief Gathers the squares of a line with one square per column.
+ *
+ * @param bitboard The bitboard.
+ * @param line The squares of the line.
+ * @return The line, indexed by column.
+ */
+static inline unsigned getDiagonalLine(Bitboard bitboard, Bitboard line)
+{
+    // Cada casilla está en otra columna: la suma de las filas no se superpone
+    return (unsigned)(((bitboard & line) * FIRST_COLUMN) >> 56);
+}
+
+/**
+ * @brief Gathers the squares of a column.
+ *
+ * @param bitboard The bitboard.
+ * @param x The column.
+ * @return The line, indexed by row.
+ */
+static inline unsigned getColumnLine(Bitboard bitboard, int x)
+{
+    return (unsigned)((((bitboard >> x) & FIRST_COLUMN) * COLUMN_TO_ROW) >> 56);
+}
+
+/**
+ * @brief Returns the discs flipped by a move, with the line tables.
+ *
+ * @param player The discs of the side to move.
+ * @param opponent The discs of the opponent.
+ * @param square The square index of the move.
+ * @return The flipped discs.
+ */
+static Bitboard getFlipsScalar(Bitboard player, Bitboard opponent, int square)
+{
+    int x = square % 8;
+    int y = square / 8;
+
+    // Fila
+    unsigned line = getLineFlips(x, (unsigned)(player >> (8 * y)) & 0xff, (unsigned)(opponent >> (8 * y)) & 0xff);
+    Bitboard flips = (Bitboard)line << (8 * y);
+
+    // Columna
+    line = getLineFlips(y, getColumnLine(player, x), getColumnLine(opponent, x));
+    flips |= flipTables.columns[line] << x;
+
+    // Diagonales: la línea repetida en cada fila, recortada a la diagonal
+    Bitboard diagonal = flipTables.diagonals[square];
+    line = getLineFlips(x, getDiagonalLine(player, diagonal), getDiagonalLine(opponent, diagonal));
+    flips |= (line * FIRST_COLUMN) & diagonal;
+
+    Bitboard antidiagonal = flipTables.antidiagonals[square];
+    line = getLineFlips(x, getDiagonalLine(player, antidiagonal), getDiagonalLine(opponent, antidiagonal));
+    flips |= (line * FIRST_COLUMN) & antidiagonal;
+
+    return flips;
+}
+
+/**
+ * @brief Returns the fastest flip kernel the CPU supports.
+ *
+ * @return The kernel.
+ */
+static FlipKernel getDefaultFlipKernel()
+{
+#ifdef EDAVERSI_AVX2
+    // Puede correr antes que los constructores de la biblioteca de GCC
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        return FLIP_KERNEL_AVX2;
+#endif
+
+    return FLIP_KERNEL_SCALAR;
+}
+
+static FlipKernel flipKernel = getDefaultFlipKernel();
+
+bool hasFlipKernel(FlipKernel kernel)
+{
+    if (kernel == FLIP_KERNEL_SCALAR)
+        return true;
+
+    return getDefaultFlipKernel() == FLIP_KERNEL_AVX2;
+}
+
+bool setFlipKernel(FlipKernel kernel)
+{
+    if (!hasFlipKernel(kernel))
+        return false;
+
+    flipKernel = kernel;
+
+    return true;
+}
+
+FlipKernel getFlipKernel()
+{
+    return flipKernel;
+}
+
+Bitboard getKernelFlips(FlipKernel kernel, Bitboard player, Bitboard opponent, int square)
+{
+#ifdef EDAVERSI_AVX2
+    if (kernel == FLIP_KERNEL_AVX2)
+        return getFlipsAVX2(player, opponent, square);
+#else
+    // Sin AVX2 sólo hay un kernel
+    (void)kernel;
+#endif
+
+    return getFlipsScalar(player, opponent, square);
+}
+
+Bitboard getFlips(Bitboard player, Bitboard opponent, int square)
+{
+    return getKernelFlips(flipKernel, player, opponent, square);
+}
+
+Bitboard makeMove(Position &position, int square)
+{
+    Bitboard flips = getFlips(position.player, position.opponent, square);
+
+    Bitboard player = position.player | flips | (1ULL << square);
+    position.player = position.opponent & ~flips;
+    position.opponent = player;
+
+    return flips;
+}
+
+void undoMove(Position &position, int square, Bitboard flips)
+{
+    Bitboard player = position.opponent & ~(flips | (1ULL << square));
+    position.opponent = position.player | flips;
+    position.player = player;
+}
+
+void passMove(Position &position)
+{
+    Bitboard player = position.player;
+    position.player = position.opponent;
+    position.opponent = player;
+}
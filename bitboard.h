@@ -0,0 +1,150 @@
+/**
+ * @brief Implements bitboard move generation
+ *
+ * @copyright Copyright (c) 2023-2024
+ */
+
+#ifndef BITBOARD_H
+#define BITBOARD_H
+
+#include <cstdint>
+
+/**
+ * @brief A set of squares, one bit per square.
+ *
+ * Bit (y * 8 + x) represents the square {x, y}.
+ */
+typedef uint64_t Bitboard;
+
+/**
+ * @brief A position seen from the side to move.
+ */
+struct Position
+{
+    Bitboard player;
+    Bitboard opponent;
+};
+
+/**
+ * @brief Returns the number of squares in a bitboard.
+ *
+ * @param bitboard The bitboard.
+ * @return The number of squares.
+ */
+inline int countBits(Bitboard bitboard)
+{
+    return __builtin_popcountll(bitboard);
+}
+
+/**
+ * @brief Returns the index of the lowest square in a non-empty bitboard.
+ *
+ * @param bitboard The bitboard.
+ * @return The square index.
+ */
+inline int getFirstBit(Bitboard bitboard)
+{
+    return __builtin_ctzll(bitboard);
+}
+
+/**
+ * @brief The ways getFlips can compute the flipped discs.
+ */
+enum FlipKernel
+{
+    FLIP_KERNEL_SCALAR,
+    FLIP_KERNEL_AVX2,
+};
+
+/**
+ * @brief Returns whether a flip kernel is built and the CPU supports it.
+ *
+ * @param kernel The kernel.
+ * @return The kernel can be used.
+ */
+bool hasFlipKernel(FlipKernel kernel);
+
+/**
+ * @brief Selects the flip kernel used by getFlips.
+ *
+ * The fastest supported kernel is selected when the program starts.
+ * Not thread safe: call it while no other thread plays moves.
+ *
+ * @param kernel The kernel.
+ * @return The kernel can be used, and was selected.
+ */
+bool setFlipKernel(FlipKernel kernel);
+
+/**
+ * @brief Returns the flip kernel used by getFlips.
+ *
+ * @return The kernel.
+ */
+FlipKernel getFlipKernel();
+
+/**
+ * @brief Returns the discs flipped by a move, with a given flip kernel.
+ *
+ * For checking the kernels against each other.
+ *
+ * @param kernel The kernel, which must be available (see hasFlipKernel).
+ * @param player The discs of the side to move.
+ * @param opponent The discs of the opponent.
+ * @param square The square index of the move.
+ * @return The flipped discs (empty if the move is illegal).
+ */
+Bitboard getKernelFlips(FlipKernel kernel, Bitboard player, Bitboard opponent, int square);
+
+/**
+ * @brief Returns the squares the side to move can play.
+ *
+ * @param player The discs of the side to move.
+ * @param opponent The discs of the opponent.
+ * @return The legal moves.
+ */
+Bitboard getMobility(Bitboard player, Bitboard opponent);
+
+/**
+ * @brief Returns the squares next to a set of squares.
+ *
+ * @param bitboard The squares.
+ * @return The squares outside the set that touch it in one of the 8 directions.
+ */
+Bitboard getNeighbours(Bitboard bitboard);
+
+/**
+ * @brief Returns the discs flipped by a move.
+ *
+ * @param player The discs of the side to move.
+ * @param opponent The discs of the opponent.
+ * @param square The square index of the move.
+ * @return The flipped discs (empty if the move is illegal).
+ */
+Bitboard getFlips(Bitboard player, Bitboard opponent, int square);
+
+/**
+ * @brief Plays a move and hands the turn to the opponent.
+ *
+ * @param position The position.
+ * @param square The square index of the move.
+ * @return The flipped discs.
+ */
+Bitboard makeMove(Position &position, int square);
+
+/**
+ * @brief Takes back a move played with makeMove.
+ *
+ * @param position The position.
+ * @param square The square index of the move.
+ * @param flips The discs the move flipped.
+ */
+void undoMove(Position &position, int square, Bitboard flips);
+
+/**
+ * @brief Hands the turn to the opponent without playing.
+ *
+ * @param position The position.
+ */
+void passMove(Position &position);
+
+#endif
@@ -0,0 +1,191 @@
+/**
+ * @brief Implements the AI's opening book
+ *
+ * @copyright Copyright (c) 2023-2024
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <random>
+
+#include "book.h"
+#include "mappedfile.h"
+#include "model.h"
+#include "symmetry.h"
+#include "trace.h"
+
+#define BOOK_MAGIC "EDAVBOOK"
+#define BOOK_VERSION 2
+
+// Se elige entre las jugadas que pierden a lo sumo estas fichas contra la mejor
+#define BOOK_RANDOM_MARGIN 2
+
+/**
+ * @brief The header of a book file, followed by the entries sorted by
+ * key and move, in the machine's byte order.
+ */
+struct BookHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t entrySize;
+    uint64_t entryCount;
+};
+
+static MappedFile bookFile;
+static const BookEntry *bookEntries;
+static size_t bookEntryCount;
+
+/**
+ * @brief Mixes the bits of a 64-bit value (SplitMix64 finalizer).
+ *
+ * @param value The value.
+ * @return The mixed value.
+ */
+static inline uint64_t mixBits(uint64_t value)
+{
+    value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+
+    return value ^ (value >> 31);
+}
+
+uint64_t getBookKey(Position &position, int &symmetry)
+{
+    Position canonical = getCanonicalPosition(position, symmetry);
+
+    return mixBits(canonical.player ^ mixBits(canonical.opponent));
+}
+
+bool loadBook(const char *path)
+{
+    freeBook();
+
+    if (!mapFile(path, bookFile))
+        return false;
+
+    const BookHeader *header = (const BookHeader *)bookFile.data;
+    if ((bookFile.size < sizeof(BookHeader)) ||
+        memcmp(header->magic, BOOK_MAGIC, sizeof(header->magic)) ||
+        (header->version != BOOK_VERSION) ||
+        (header->entrySize != sizeof(BookEntry)) ||
+        (bookFile.size != sizeof(BookHeader) + header->entryCount * sizeof(BookEntry)))
+    {
+        fprintf(stderr, "%s: not a version %d book file\n", path, BOOK_VERSION);
+        unmapFile(bookFile);
+
+        return false;
+    }
+
+    bookEntries = (const BookEntry *)(header + 1);
+    bookEntryCount = (size_t)header->entryCount;
+
+    return true;
+}
+
+void freeBook()
+{
+    unmapFile(bookFile);
+    bookEntries = nullptr;
+    bookEntryCount = 0;
+}
+
+bool hasBook()
+{
+    return bookEntries != nullptr;
+}
+
+bool probeBook(Position &position, uint64_t *seed, int &square, int &score, int &depth)
+{
+    if (!bookEntries)
+        return false;
+
+    TRACE_SCOPE("probeBook");
+
+    int symmetry;
+    uint64_t key = getBookKey(position, symmetry);
+
+    const BookEntry *end = bookEntries + bookEntryCount;
+    const BookEntry *first = std::lower_bound(bookEntries,
+                                              end,
+                                              key,
+                                              [](const BookEntry &entry, uint64_t key) {
+                                                  return entry.key < key;
+                                              });
+    const BookEntry *last = first;
+    while ((last != end) && (last->key == key))
+        last++;
+
+    // Una jugada ilegal delata una colisión de claves
+    Bitboard validMoves = getMobility(position.player, position.opponent);
+    int bestScore = -BOARD_SIZE * BOARD_SIZE;
+    for (const BookEntry *entry = first; entry != last; entry++)
+    {
+        if (!(validMoves & (1ULL << untransformSquare(entry->move, symmetry))))
+            return false;
+
+        bestScore = std::max(bestScore, (int)entry->score);
+    }
+    if (first == last)
+        return false;
+
+    // Cuanto mejor es la jugada y más libro hay detrás, más probable
+    auto getWeight = [&](const BookEntry *entry) {
+        return (uint64_t)std::max(BOOK_RANDOM_MARGIN + 1 - (bestScore - entry->score), 0) *
+               ((uint64_t)entry->count + 1);
+    };
+    uint64_t totalWeight = 0;
+    for (const BookEntry *entry = first; entry != last; entry++)
+        totalWeight += getWeight(entry);
+
+    uint64_t choice;
+    if (seed)
+    {
+        *seed = *seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        choice = (*seed >> 33) % totalWeight;
+    }
+    else
+    {
+        thread_local std::mt19937_64 random(std::random_device{}());
+        choice = std::uniform_int_distribution<uint64_t>(0, totalWeight - 1)(random);
+    }
+    for (const BookEntry *entry = first; entry != last; entry++)
+    {
+        if (choice < getWeight(entry))
+        {
+            square = untransformSquare(entry->move, symmetry);
+            score = entry->score;
+            depth = entry->depth;
+
+            return true;
+        }
+
+        choice -= getWeight(entry);
+    }
+
+    return false;
+}
+
+bool saveBook(const char *path, std::vector<BookEntry> &entries)
+{
+    std::sort(entries.begin(), entries.end(), [](const BookEntry &a, const BookEntry &b) {
+        return (a.key < b.key) || ((a.key == b.key) && (a.move < b.move));
+    });
+
+    FILE *file = fopen(path, "wb");
+    if (!file)
+        return false;
+
+    BookHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, BOOK_MAGIC, sizeof(header.magic));
+    header.version = BOOK_VERSION;
+    header.entrySize = sizeof(BookEntry);
+    header.entryCount = entries.size();
+
+    bool written = (fwrite(&header, sizeof(header), 1, file) == 1) &&
+                   (fwrite(entries.data(), sizeof(BookEntry), entries.size(), file) == entries.size());
+
+    return (fclose(file) == 0) && written;
+}
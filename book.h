@@ -0,0 +1,86 @@
+/**
+ * @brief Implements the AI's opening book
+ *
+ * @copyright Copyright (c) 2023-2024
+ */
+
+#ifndef BOOK_H
+#define BOOK_H
+
+#include <cstdint>
+#include <vector>
+
+#include "bitboard.h"
+
+/**
+ * @brief A book move, as stored in the book file.
+ *
+ * Positions are stored in a canonical orientation, the same for all 8
+ * symmetric positions, and moves in the same orientation.
+ */
+struct BookEntry
+{
+    uint64_t key;  // Clave de la posición canónica
+    int16_t score; // Valor de la jugada para el que mueve, en fichas
+    uint8_t move;  // Casilla de la jugada en la posición canónica
+    uint8_t depth; // Profundidad con la que se buscó
+    uint32_t count; // Posiciones del libro a las que se llegó por esta jugada
+};
+
+/**
+ * @brief Returns the book key of a position.
+ *
+ * @param position The position.
+ * @param symmetry Receives the symmetry that takes the position to its
+ * canonical orientation.
+ * @return The key.
+ */
+uint64_t getBookKey(Position &position, int &symmetry);
+
+/**
+ * @brief Memory-maps a book file.
+ *
+ * @param path The path of the file.
+ * @return The file was mapped and has the expected format.
+ */
+bool loadBook(const char *path);
+
+/**
+ * @brief Unmaps the book file.
+ */
+void freeBook();
+
+/**
+ * @brief Checks whether a book file is loaded.
+ *
+ * @return true or false.
+ */
+bool hasBook();
+
+/**
+ * @brief Chooses a book move for a position.
+ *
+ * Chooses at random among the moves within a few discs of the best one,
+ * favouring the better ones and those with more book positions after
+ * them, which keep the game in the book for longer.
+ *
+ * @param position The position.
+ * @param seed The state of the random generator that chooses the move,
+ * or nullptr to choose with a generator of the calling thread.
+ * @param square Receives the square index of the move.
+ * @param score Receives the move's value, in discs.
+ * @param depth Receives the depth the move was searched to.
+ * @return The position is in the book.
+ */
+bool probeBook(Position &position, uint64_t *seed, int &square, int &score, int &depth);
+
+/**
+ * @brief Sorts book entries and writes them to a book file.
+ *
+ * @param path The path of the file.
+ * @param entries The entries.
+ * @return The file was written.
+ */
+bool saveBook(const char *path, std::vector<BookEntry> &entries);
+
+#endif
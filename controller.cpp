@@ -9,14 +9,21 @@
 
 #include "raylib.h"
 
-#include "ai.h"
+#include "aiservice.h"
+#include "trace.h"
 #include "view.h"
 #include "controller.h"
 
 bool updateView(GameModel &model)
 {
+    TRACE_SCOPE("updateView");
+
     if (WindowShouldClose())
+    {
+        stopBestMoveSearch();
+
         return false;
+    }
 
     if (model.gameOver)
     {
@@ -38,6 +45,10 @@ bool updateView(GameModel &model)
     }
     else if (model.currentPlayer == model.humanPlayer)
     {
+        // While the human thinks, the AI ponders
+        if (!isBestMoveSearchRunning())
+            startPonderSearch(model);
+
         if (IsMouseButtonPressed(0))
         {
             // Human player
@@ -53,17 +64,28 @@ bool updateView(GameModel &model)
                 {
                     if ((square.x == move.x) &&
                         (square.y == move.y))
+                    {
                         playMove(model, square);
+
+                        // If the AI pondered this position, its search goes on
+                        if (model.gameOver ||
+                            (model.currentPlayer == model.humanPlayer) ||
+                            !ponderHitBestMoveSearch(model))
+                            stopBestMoveSearch();
+                    }
                 }
             }
         }
     }
     else
     {
-        // AI player
-        Square square = getBestMove(model);
+        // AI player: searches on another thread, so the view keeps drawing
+        if (!isBestMoveSearchRunning())
+            startBestMoveSearch(model);
 
-        playMove(model, square);
+        Square square;
+        if (pollBestMoveSearch(square))
+            playMove(model, square);
     }
 
     if ((IsKeyDown(KEY_LEFT_ALT) ||
@@ -71,7 +93,15 @@ bool updateView(GameModel &model)
         IsKeyPressed(KEY_ENTER))
         ToggleFullscreen();
 
-    drawView(model);
+    // Tab shows the statistics of the AI's last search
+    static bool showSearchStats = false;
+    if (IsKeyPressed(KEY_TAB))
+        showSearchStats = !showSearchStats;
+
+    SearchInfo searchInfo;
+    bool hasSearchInfo = showSearchStats && getLastSearchInfo(searchInfo);
+
+    drawView(model, hasSearchInfo ? &searchInfo : nullptr);
 
     return true;
 }
@@ -0,0 +1,603 @@
+/**
+ * @brief Implements the AI's exact endgame solver
+ *
+ * @copyright Copyright (c) 2023-2024
+ */
+
+#include "endgame.h"
+#include "trace.h"
+#include "transposition.h"
+
+// Con menos casillas vacías consultar la tabla cuesta más de lo que ahorra
+#define ENDGAME_TT_MIN_EMPTIES 10
+// Con menos casillas vacías las jugadas se ordenan solo por paridad
+#define FASTEST_FIRST_MIN_EMPTIES 7
+// Con estas casillas vacías o menos se usan las rutinas desenrolladas
+#define LAST_MOVES_EMPTIES 4
+
+// Mayor que cualquier diferencia de fichas
+#define ENDGAME_INFINITY (BOARD_SIZE * BOARD_SIZE + 1)
+
+#define ORDER_TT_MOVE (1 << 30)
+// Peso de jugar en una región con un número impar de casillas vacías
+#define PARITY_WEIGHT 8
+
+#define CORNERS 0x8100000000000081ULL
+
+// La cabeza de la lista de casillas vacías
+#define EMPTY_LIST_HEAD (BOARD_SIZE * BOARD_SIZE)
+
+/**
+ * @brief Squares from best to worst: corners first, X squares and the
+ * centre last. The empty list keeps this order.
+ */
+static const int presortedSquares[BOARD_SIZE * BOARD_SIZE] = {
+     0,  7, 56, 63,  2,  5, 16, 23,
+    40, 47, 58, 61, 18, 21, 42, 45,
+     3,  4, 24, 31, 32, 39, 59, 60,
+    19, 20, 26, 29, 34, 37, 43, 44,
+    11, 12, 25, 30, 33, 38, 51, 52,
+    10, 13, 17, 22, 41, 46, 50, 53,
+     1,  6,  8, 15, 48, 55, 57, 62,
+     9, 14, 49, 54, 27, 28, 35, 36,
+};
+
+/**
+ * @brief A doubly linked list of the empty squares, and the parity of
+ * the empty squares in each quadrant.
+ */
+struct EmptyList
+{
+    int previous[BOARD_SIZE * BOARD_SIZE + 1];
+    int next[BOARD_SIZE * BOARD_SIZE + 1];
+    unsigned parity;
+};
+
+/**
+ * @brief Returns the bit of a square's quadrant in the parity mask.
+ *
+ * @param square The square index.
+ * @return The quadrant bit.
+ */
+static inline unsigned getQuadrant(int square)
+{
+    return 1U << (((square >> 5) << 1) | ((square & 7) >> 2));
+}
+
+/**
+ * @brief Builds the empty list of a position.
+ *
+ * @param position The position.
+ * @param empties Receives the empty list.
+ */
+static void initEmptyList(Position &position, EmptyList &empties)
+{
+    Bitboard emptySquares = ~(position.player | position.opponent);
+
+    int last = EMPTY_LIST_HEAD;
+    empties.parity = 0;
+    for (int i = 0; i < BOARD_SIZE * BOARD_SIZE; i++)
+    {
+        int square = presortedSquares[i];
+        if (!(emptySquares & (1ULL << square)))
+            continue;
+
+        empties.next[last] = square;
+        empties.previous[square] = last;
+        empties.parity ^= getQuadrant(square);
+        last = square;
+    }
+    empties.next[last] = EMPTY_LIST_HEAD;
+    empties.previous[EMPTY_LIST_HEAD] = last;
+}
+
+/**
+ * @brief Takes a square out of the empty list.
+ *
+ * @param empties The empty list.
+ * @param square The square index.
+ */
+static inline void removeEmpty(EmptyList &empties, int square)
+{
+    empties.next[empties.previous[square]] = empties.next[square];
+    empties.previous[empties.next[square]] = empties.previous[square];
+    empties.parity ^= getQuadrant(square);
+}
+
+/**
+ * @brief Puts back a square taken out with removeEmpty.
+ *
+ * @param empties The empty list.
+ * @param square The square index.
+ */
+static inline void restoreEmpty(EmptyList &empties, int square)
+{
+    empties.next[empties.previous[square]] = square;
+    empties.previous[empties.next[square]] = square;
+    empties.parity ^= getQuadrant(square);
+}
+
+/**
+ * @brief Plays a move on a copy of a position.
+ *
+ * @param position The position.
+ * @param square The square index of the move.
+ * @param next Receives the position after the move.
+ * @return The move is legal.
+ */
+static inline bool playLastMove(Position &position, int square, Position &next)
+{
+    Bitboard flips = getFlips(position.player, position.opponent, square);
+    if (!flips)
+        return false;
+
+    next.player = position.opponent ^ flips;
+    next.opponent = position.player | flips | (1ULL << square);
+
+    return true;
+}
+
+/**
+ * @brief Solves a position with one empty square.
+ *
+ * @param position The position.
+ * @param square The empty square.
+ * @param state The search state.
+ * @return The final score.
+ */
+static int solveLast1(Position &position, int square, SearchState &state)
+{
+    state.nodes++;
+
+    // Con 63 fichas la diferencia es impar: nunca hay empate
+    int score = 2 * countBits(position.player) - (BOARD_SIZE * BOARD_SIZE - 1);
+
+    int flips = countBits(getFlips(position.player, position.opponent, square));
+    if (flips)
+        return score + 2 * flips + 1;
+
+    flips = countBits(getFlips(position.opponent, position.player, square));
+    if (flips)
+        return score - 2 * flips - 1;
+
+    return (score > 0) ? (score + 1) : (score - 1);
+}
+
+/**
+ * @brief Solves a position with two empty squares.
+ *
+ * @param position The position.
+ * @param alpha The lower bound of the window.
+ * @param beta The upper bound of the window.
+ * @param square1 The first empty square.
+ * @param square2 The second empty square.
+ * @param state The search state.
+ * @return The final score.
+ */
+static int solveLast2(Position &position,
+                      int alpha,
+                      int beta,
+                      int square1,
+                      int square2,
+                      SearchState &state)
+{
+    state.nodes++;
+
+    int bestValue = -ENDGAME_INFINITY;
+    Position next;
+
+    if (playLastMove(position, square1, next))
+    {
+        bestValue = -solveLast1(next, square2, state);
+        if (bestValue >= beta)
+            return bestValue;
+    }
+    if (playLastMove(position, square2, next))
+    {
+        int value = -solveLast1(next, square1, state);
+        if (value > bestValue)
+            bestValue = value;
+    }
+
+    if (bestValue == -ENDGAME_INFINITY)
+    {
+        // Si el rival puede jugar se pasa; si no, terminó el juego
+        Position passed = {position.opponent, position.player};
+        if (playLastMove(passed, square1, next) || playLastMove(passed, square2, next))
+            return -solveLast2(passed, -beta, -alpha, square1, square2, state);
+
+        return getFinalScore(position);
+    }
+
+    return bestValue;
+}
+
+/**
+ * @brief Solves a position with three empty squares.
+ *
+ * @param position The position.
+ * @param alpha The lower bound of the window.
+ * @param beta The upper bound of the window.
+ * @param square1 The first empty square.
+ * @param square2 The second empty square.
+ * @param square3 The third empty square.
+ * @param state The search state.
+ * @return The final score.
+ */
+static int solveLast3(Position &position,
+                      int alpha,
+                      int beta,
+                      int square1,
+                      int square2,
+                      int square3,
+                      SearchState &state)
+{
+    state.nodes++;
+
+    int bestValue = -ENDGAME_INFINITY;
+    Position next;
+
+    if (playLastMove(position, square1, next))
+    {
+        bestValue = -solveLast2(next, -beta, -alpha, square2, square3, state);
+        if (bestValue >= beta)
+            return bestValue;
+        if (bestValue > alpha)
+            alpha = bestValue;
+    }
+    if (playLastMove(position, square2, next))
+    {
+        int value = -solveLast2(next, -beta, -alpha, square1, square3, state);
+        if (value >= beta)
+            return value;
+        if (value > bestValue)
+        {
+            bestValue = value;
+            if (value > alpha)
+                alpha = value;
+        }
+    }
+    if (playLastMove(position, square3, next))
+    {
+        int value = -solveLast2(next, -beta, -alpha, square1, square2, state);
+        if (value > bestValue)
+            bestValue = value;
+    }
+
+    if (bestValue == -ENDGAME_INFINITY)
+    {
+        Position passed = {position.opponent, position.player};
+        if (playLastMove(passed, square1, next) ||
+            playLastMove(passed, square2, next) ||
+            playLastMove(passed, square3, next))
+            return -solveLast3(passed, -beta, -alpha, square1, square2, square3, state);
+
+        return getFinalScore(position);
+    }
+
+    return bestValue;
+}
+
+/**
+ * @brief Solves a position with four empty squares.
+ *
+ * @param position The position.
+ * @param alpha The lower bound of the window.
+ * @param beta The upper bound of the window.
+ * @param square1 The first empty square.
+ * @param square2 The second empty square.
+ * @param square3 The third empty square.
+ * @param square4 The fourth empty square.
+ * @param state The search state.
+ * @return The final score.
+ */
+static int solveLast4(Position &position,
+                      int alpha,
+                      int beta,
+                      int square1,
+                      int square2,
+                      int square3,
+                      int square4,
+                      SearchState &state)
+{
+    state.nodes++;
+
+    int bestValue = -ENDGAME_INFINITY;
+    Position next;
+
+    if (playLastMove(position, square1, next))
+    {
+        bestValue = -solveLast3(next, -beta, -alpha, square2, square3, square4, state);
+        if (bestValue >= beta)
+            return bestValue;
+        if (bestValue > alpha)
+            alpha = bestValue;
+    }
+    if (playLastMove(position, square2, next))
+    {
+        int value = -solveLast3(next, -beta, -alpha, square1, square3, square4, state);
+        if (value >= beta)
+            return value;
+        if (value > bestValue)
+        {
+            bestValue = value;
+            if (value > alpha)
+                alpha = value;
+        }
+    }
+    if (playLastMove(position, square3, next))
+    {
+        int value = -solveLast3(next, -beta, -alpha, square1, square2, square4, state);
+        if (value >= beta)
+            return value;
+        if (value > bestValue)
+        {
+            bestValue = value;
+            if (value > alpha)
+                alpha = value;
+        }
+    }
+    if (playLastMove(position, square4, next))
+    {
+        int value = -solveLast3(next, -beta, -alpha, square1, square2, square3, state);
+        if (value > bestValue)
+            bestValue = value;
+    }
+
+    if (bestValue == -ENDGAME_INFINITY)
+    {
+        Position passed = {position.opponent, position.player};
+        if (playLastMove(passed, square1, next) ||
+            playLastMove(passed, square2, next) ||
+            playLastMove(passed, square3, next) ||
+            playLastMove(passed, square4, next))
+            return -solveLast4(passed, -beta, -alpha, square1, square2, square3, square4, state);
+
+        return getFinalScore(position);
+    }
+
+    return bestValue;
+}
+
+/**
+ * @brief Solves a position with at most four empty squares.
+ *
+ * The squares in quadrants with an odd number of empties go first:
+ * playing there tends to leave the opponent the last move elsewhere.
+ *
+ * @param position The position.
+ * @param empties The empty list.
+ * @param emptyCount The number of empty squares.
+ * @param alpha The lower bound of the window.
+ * @param beta The upper bound of the window.
+ * @param state The search state.
+ * @return The final score.
+ */
+static int solveLastMoves(Position &position,
+                          EmptyList &empties,
+                          int emptyCount,
+                          int alpha,
+                          int beta,
+                          SearchState &state)
+{
+    int squares[LAST_MOVES_EMPTIES];
+    int count = 0;
+
+    for (int square = empties.next[EMPTY_LIST_HEAD];
+         square != EMPTY_LIST_HEAD;
+         square = empties.next[square])
+    {
+        if (empties.parity & getQuadrant(square))
+            squares[count++] = square;
+    }
+    for (int square = empties.next[EMPTY_LIST_HEAD];
+         square != EMPTY_LIST_HEAD;
+         square = empties.next[square])
+    {
+        if (!(empties.parity & getQuadrant(square)))
+            squares[count++] = square;
+    }
+
+    switch (emptyCount)
+    {
+    case 4:
+        return solveLast4(position, alpha, beta, squares[0], squares[1], squares[2], squares[3], state);
+    case 3:
+        return solveLast3(position, alpha, beta, squares[0], squares[1], squares[2], state);
+    case 2:
+        return solveLast2(position, alpha, beta, squares[0], squares[1], state);
+    case 1:
+        return solveLast1(position, squares[0], state);
+    default:
+        return getFinalScore(position);
+    }
+}
+
+/**
+ * @brief Solves a position with principal variation search.
+ *
+ * @param node The search position.
+ * @param empties The empty list.
+ * @param emptyCount The number of empty squares.
+ * @param alpha The lower bound of the window.
+ * @param beta The upper bound of the window.
+ * @param state The search state.
+ * @return The final score.
+ */
+static int solve(SearchPosition &node,
+                 EmptyList &empties,
+                 int emptyCount,
+                 int alpha,
+                 int beta,
+                 SearchState &state)
+{
+    Position &position = node.position;
+
+    if (emptyCount <= LAST_MOVES_EMPTIES)
+    {
+        state.stats.leaves++;
+        return solveLastMoves(position, empties, emptyCount, alpha, beta, state);
+    }
+
+    if (isSearchAborted(state))
+        return 0;
+
+    Bitboard moves = getMobility(position.player, position.opponent);
+    if (!moves)
+    {
+        if (!getMobility(position.opponent, position.player))
+            return getFinalScore(position);
+
+        passMove(position);
+        node.hashKey ^= getPassHashKey();
+        node.player = getOpponent(node.player);
+
+        int value = -solve(node, empties, emptyCount, -beta, -alpha, state);
+
+        passMove(position);
+        node.hashKey ^= getPassHashKey();
+        node.player = getOpponent(node.player);
+
+        return value;
+    }
+
+    // Lejos del final la tabla de transposición ahorra búsquedas repetidas.
+    // Un resultado exacto vale como una búsqueda de profundidad emptyCount
+    TTEntry entry;
+    int ttMove = TT_NO_MOVE;
+    bool useTable = (emptyCount >= ENDGAME_TT_MIN_EMPTIES);
+    if (useTable)
+        state.stats.ttProbes++;
+    if (useTable && probeTranspositionTable(state.table, node.hashKey, entry))
+    {
+        state.stats.ttHits++;
+
+        if (entry.depth >= emptyCount)
+        {
+            if ((entry.bound == TT_BOUND_EXACT) ||
+                ((entry.bound == TT_BOUND_LOWER) && (entry.score >= beta)) ||
+                ((entry.bound == TT_BOUND_UPPER) && (entry.score <= alpha)))
+            {
+                state.stats.ttCutoffs++;
+                return entry.score;
+            }
+        }
+
+        ttMove = entry.move;
+    }
+
+    // Jugadas en el orden de la lista, con su puntaje de orden
+    int squares[MAX_MOVES];
+    int scores[MAX_MOVES];
+    int count = 0;
+    for (int square = empties.next[EMPTY_LIST_HEAD];
+         square != EMPTY_LIST_HEAD;
+         square = empties.next[square])
+    {
+        if (!(moves & (1ULL << square)))
+            continue;
+
+        int score = (empties.parity & getQuadrant(square)) ? PARITY_WEIGHT : 0;
+        if (square == ttMove)
+            score = ORDER_TT_MOVE;
+        else if (emptyCount >= FASTEST_FIRST_MIN_EMPTIES)
+        {
+            // Primero las jugadas que le dejan menos opciones al rival
+            Position next = {};
+            playLastMove(position, square, next);
+            Bitboard replies = getMobility(next.player, next.opponent);
+
+            score -= (countBits(replies) + countBits(replies & CORNERS)) << 4;
+        }
+
+        // Inserción estable: a igual puntaje se respeta el orden de la lista
+        int j = count - 1;
+        for (; (j >= 0) && (scores[j] < score); j--)
+        {
+            squares[j + 1] = squares[j];
+            scores[j + 1] = scores[j];
+        }
+        squares[j + 1] = square;
+        scores[j + 1] = score;
+        count++;
+    }
+
+    int alphaOriginal = alpha;
+    int bestValue = -ENDGAME_INFINITY;
+    int bestMove = TT_NO_MOVE;
+    state.stats.expandedNodes++;
+
+    for (int i = 0; i < count; i++)
+    {
+        int square = squares[i];
+
+        Player player = node.player;
+        uint64_t hashKey = node.hashKey;
+        Bitboard flips = makeMove(position, square);
+        node.hashKey ^= getMoveHashKey(player, square, flips);
+        node.player = getOpponent(player);
+        removeEmpty(empties, square);
+
+        int value;
+        if (i == 0)
+            value = -solve(node, empties, emptyCount - 1, -beta, -alpha, state);
+        else
+        {
+            // Ventana nula: solo se busca de nuevo si la jugada supera a la mejor
+            value = -solve(node, empties, emptyCount - 1, -alpha - 1, -alpha, state);
+            if ((value > alpha) && (value < beta))
+                value = -solve(node, empties, emptyCount - 1, -beta, -alpha, state);
+        }
+
+        restoreEmpty(empties, square);
+        undoMove(position, square, flips);
+        node.hashKey = hashKey;
+        node.player = player;
+
+        if (state.aborted)
+            return 0;
+
+        if (value > bestValue)
+        {
+            bestValue = value;
+            bestMove = square;
+        }
+        if (value > alpha)
+            alpha = value;
+        if (alpha >= beta)
+        {
+            state.stats.betaCutoffs++;
+            if (i == 0)
+                state.stats.firstMoveCutoffs++;
+            break;
+        }
+    }
+
+    if (useTable)
+    {
+        TTBound bound = TT_BOUND_EXACT;
+        if (bestValue <= alphaOriginal)
+            bound = TT_BOUND_UPPER;
+        else if (bestValue >= beta)
+            bound = TT_BOUND_LOWER;
+        storeTranspositionTable(state.table, node.hashKey, emptyCount, bestValue, bound, bestMove);
+    }
+
+    return bestValue;
+}
+
+int solveEndgame(SearchPosition &node, int alpha, int beta, SearchState &state)
+{
+    TRACE_SCOPE("solveEndgame");
+
+    EmptyList empties;
+    initEmptyList(node.position, empties);
+
+    int emptyCount = BOARD_SIZE * BOARD_SIZE - countBits(node.position.player | node.position.opponent);
+
+    // Las puntuaciones finales están entre -64 y 64
+    alpha = (alpha < -ENDGAME_INFINITY) ? -ENDGAME_INFINITY : alpha;
+    beta = (beta > ENDGAME_INFINITY) ? ENDGAME_INFINITY : beta;
+
+    return solve(node, empties, emptyCount, alpha, beta, state);
+}
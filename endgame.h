@@ -0,0 +1,28 @@
+/**
+ * @brief Implements the AI's exact endgame solver
+ *
+ * @copyright Copyright (c) 2023-2024
+ */
+
+#ifndef ENDGAME_H
+#define ENDGAME_H
+
+#include "ai.h"
+
+/**
+ * @brief Solves a position exactly, searching every move to the end.
+ *
+ * Keeps a list of the empty squares, orders moves fastest-first and by
+ * region parity, and plays the last four empties with unrolled
+ * routines. Uses the transposition table far from the end of the game.
+ *
+ * @param node The search position.
+ * @param alpha The lower bound of the window.
+ * @param beta The upper bound of the window.
+ * @param state The search state.
+ * @return The final disc difference (empties to the winner), from the
+ *         side to move's point of view.
+ */
+int solveEndgame(SearchPosition &node, int alpha, int beta, SearchState &state);
+
+#endif
@@ -0,0 +1,241 @@
+/**
+ * @brief Solves endgame test positions and reports time and node counts
+ *
+ * Usage: edaversi_ffo [-range first-last] [file [threads]]
+ *
+ * Each line of the file holds a position as in the FFO/Edax .obf test
+ * files: 64 squares (X black, O white, - empty) row by row from a1,
+ * the side to move and, optionally, "; move:score" annotations with
+ * the expected results and a "; #number" label. The first annotation
+ * gives the expected score; the solve fails if the score differs or the
+ * move is not one of those annotated with that score. Without a file,
+ * the built-in positions are solved. With -range, only the positions
+ * labelled #first to #last are.
+ *
+ * @copyright Copyright (c) 2023-2024
+ */
+
+#include <cctype>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "ai.h"
+#include "transposition.h"
+
+/**
+ * @brief Built-in test positions, from the FFO endgame suite.
+ */
+static const char *ffoPositions[] = {
+    "O--OOOOX-OOOOOOXOOXXOOOXOOXOOOXXOOOOOOXX---OOOOX----O--X-------- X; A2:+38; #40",
+    "-OOOOO----OOOOX--OOOOOO-XXXXXOO--XXOOX--OOXOXX----OXXO---OOO--O- X; H4:+0; #41",
+    "--OOO-------XX-OOOOOOXOO-OOOOXOOX-OOOXXO---OOXOO---OOOXO--OOOO-- X; G2:+6; #42",
+    "--XXXXX---XXXX---OOOXX---OOXXXX--OOXXXO-OOOOXOO----XOX----XXXXX- O; C7:-12; G3:-12; #43",
+    "--O-X-O---O-XO-O-OOXXXOOOOOOXXXOOOOOXX--XXOOXO----XXXX-----XXX-- O; D2:-14; B8:-14; #44",
+    "---XXXX-X-XXXO--XXOXOO--XXXOXO--XXOXXO---OXXXOO-O-OOOO------OO-- X; B2:+6; #45",
+    "---XXX----OOOX----OOOXX--OOOOXXX--OOOOXX--OXOXXX--XXOO---XXXX-O- X; B3:-8; #46",
+};
+
+/**
+ * @brief Reads a position line into a game model.
+ *
+ * @param line The line.
+ * @param model Receives the position.
+ * @param expectedScore Receives the expected score, if annotated.
+ * @param hasExpectedScore Receives whether the line has an expected score.
+ * @param expectedMoves Receives the moves annotated with the expected score.
+ * @param label Receives the "#number" label, or an empty string.
+ * @return The line holds a position.
+ */
+static bool readPosition(const std::string &line,
+                         GameModel &model,
+                         int &expectedScore,
+                         bool &hasExpectedScore,
+                         std::vector<Square> &expectedMoves,
+                         std::string &label)
+{
+    if (line.size() < BOARD_SIZE * BOARD_SIZE + 2)
+        return false;
+
+    initModel(model);
+    model.gameOver = false;
+    model.playerTime[PLAYER_BLACK] = 0;
+    model.playerTime[PLAYER_WHITE] = 0;
+    model.turnTimer = getClockTime();
+
+    for (int i = 0; i < BOARD_SIZE * BOARD_SIZE; i++)
+    {
+        Square square = {i % BOARD_SIZE, i / BOARD_SIZE};
+
+        switch (line[i])
+        {
+        case 'X':
+        case 'x':
+        case '*':
+            setBoardPiece(model, square, PIECE_BLACK);
+            break;
+        case 'O':
+        case 'o':
+            setBoardPiece(model, square, PIECE_WHITE);
+            break;
+        case '-':
+        case '.':
+            setBoardPiece(model, square, PIECE_EMPTY);
+            break;
+        default:
+            return false;
+        }
+    }
+
+    char side = line[BOARD_SIZE * BOARD_SIZE + 1];
+    if ((side == 'X') || (side == 'x') || (side == '*'))
+        model.currentPlayer = PLAYER_BLACK;
+    else if ((side == 'O') || (side == 'o'))
+        model.currentPlayer = PLAYER_WHITE;
+    else
+        return false;
+
+    // La primera anotación "jugada:puntaje" es el resultado esperado; las
+    // jugadas con ese mismo puntaje son las correctas
+    hasExpectedScore = false;
+    expectedMoves.clear();
+    for (size_t colon = line.find(':'); colon != std::string::npos; colon = line.find(':', colon + 1))
+    {
+        if (colon < 2)
+            continue;
+
+        Square square = {tolower(line[colon - 2]) - 'a', line[colon - 1] - '1'};
+        if ((square.x < 0) || (square.x >= BOARD_SIZE) || (square.y < 0) || (square.y >= BOARD_SIZE))
+            continue;
+
+        int score = atoi(line.c_str() + colon + 1);
+        if (!hasExpectedScore)
+        {
+            expectedScore = score;
+            hasExpectedScore = true;
+        }
+        if (score == expectedScore)
+            expectedMoves.push_back(square);
+    }
+
+    // El número de la posición en la serie FFO
+    label.clear();
+    size_t hash = line.find('#');
+    if (hash != std::string::npos)
+        label = "#" + std::to_string(atoi(line.c_str() + hash + 1));
+
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    int firstLabel = 0;
+    int lastLabel = INT_MAX;
+    if ((argc > 2) && !strcmp(argv[1], "-range"))
+    {
+        if (sscanf(argv[2], "%d-%d", &firstLabel, &lastLabel) != 2)
+        {
+            fprintf(stderr, "Invalid range: %s\n", argv[2]);
+            return 1;
+        }
+        argc -= 2;
+        argv += 2;
+    }
+
+    std::vector<std::string> lines;
+    if (argc > 1)
+    {
+        FILE *file = fopen(argv[1], "r");
+        if (!file)
+        {
+            fprintf(stderr, "Could not open %s\n", argv[1]);
+            return 1;
+        }
+
+        char buffer[256];
+        while (fgets(buffer, sizeof(buffer), file))
+            lines.push_back(buffer);
+
+        fclose(file);
+    }
+    else
+    {
+        for (const char *position : ffoPositions)
+            lines.push_back(position);
+    }
+
+    SearchLimits limits;
+    initSearchLimits(limits);
+    limits.gameTime = 1e9;
+    limits.endgameEmpties = BOARD_SIZE * BOARD_SIZE;
+    if (argc > 2)
+        limits.threadCount = atoi(argv[2]);
+
+    printf("    # empties move score expected       nodes  time (s)   nodes/s\n");
+
+    double totalTime = 0;
+    uint64_t totalNodes = 0;
+    int failures = 0;
+    for (std::string &line : lines)
+    {
+        GameModel model;
+        int expectedScore = 0;
+        bool hasExpectedScore;
+        std::vector<Square> expectedMoves;
+        std::string label;
+        if (!readPosition(line, model, expectedScore, hasExpectedScore, expectedMoves, label))
+            continue;
+
+        int number = label.empty() ? 0 : atoi(label.c_str() + 1);
+        if ((number < firstLabel) || (number > lastLabel))
+            continue;
+
+        Position position = getPosition(model);
+        int emptyCount = BOARD_SIZE * BOARD_SIZE - countBits(position.player | position.opponent);
+
+        // Cada posición empieza con la tabla vacía
+        clearTranspositionTable(getSharedTranspositionTable());
+
+        SearchInfo info;
+        Square move = getBestMove(model, limits, info);
+
+        bool solved = (info.depth == emptyCount);
+        bool expectedMove = !hasExpectedScore;
+        for (Square square : expectedMoves)
+            expectedMove |= (square.x == move.x) && (square.y == move.y);
+        bool failed = !solved ||
+                      (hasExpectedScore && (info.score != expectedScore)) ||
+                      !expectedMove;
+        if (failed)
+            failures++;
+
+        char expected[16] = "";
+        if (hasExpectedScore)
+            snprintf(expected, sizeof(expected), "%+d", expectedScore);
+
+        printf("%5s %7d   %c%d %+5d %8s %11llu %9.3f %9.0f%s\n",
+               label.empty() ? "-" : label.c_str(),
+               emptyCount,
+               'a' + move.x,
+               move.y + 1,
+               info.score,
+               expected,
+               (unsigned long long)info.nodes,
+               info.time,
+               info.nodes / info.time,
+               failed ? "  FAILED" : "");
+
+        totalTime += info.time;
+        totalNodes += info.nodes;
+    }
+
+    printf("total %43llu %9.3f %9.0f\n",
+           (unsigned long long)totalNodes,
+           totalTime,
+           totalNodes / totalTime);
+
+    return failures ? 1 : 0;
+}
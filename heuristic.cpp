@@ -0,0 +1,96 @@
+/**
+ * @brief Implements the AI's heuristic evaluation
+ *
+ * @copyright Copyright (c) 2023-2024
+ */
+
+#include "heuristic.h"
+
+// Los pesos están en fracciones de ficha
+#define HEURISTIC_SCALE 16
+// Casillas vacías al empezar la partida
+#define OPENING_EMPTIES 60
+
+#define CORNERS 0x8100000000000081ULL
+
+/**
+ * @brief The weight of each term, in 1/HEURISTIC_SCALE of a disc.
+ */
+struct HeuristicWeights
+{
+    int mobility;          // Por jugada de diferencia
+    int potentialMobility; // Por casilla vacía junto a fichas rivales
+    int corners;
+    int xSquares; // Casillas en diagonal a una esquina vacía
+    int cSquares; // Casillas junto a una esquina vacía, sobre el borde
+    int discs;
+};
+
+// Entre la apertura y el final los pesos se interpolan linealmente
+static const HeuristicWeights openingWeights = {32, 12, 240, -96, -32, 0};
+static const HeuristicWeights endgameWeights = {16, 4, 128, -32, -8, 4};
+
+/**
+ * @brief A corner with its X and C squares.
+ */
+struct CornerSquares
+{
+    Bitboard corner;
+    Bitboard xSquare;
+    Bitboard cSquares;
+};
+
+static const CornerSquares cornerSquares[] = {
+    {1ULL << 0, 1ULL << 9, (1ULL << 1) | (1ULL << 8)},
+    {1ULL << 7, 1ULL << 14, (1ULL << 6) | (1ULL << 15)},
+    {1ULL << 56, 1ULL << 49, (1ULL << 57) | (1ULL << 48)},
+    {1ULL << 63, 1ULL << 54, (1ULL << 62) | (1ULL << 55)},
+};
+
+int evaluateHeuristic(Position &position, int emptyCount)
+{
+    Bitboard player = position.player;
+    Bitboard opponent = position.opponent;
+    Bitboard empty = ~(player | opponent);
+
+    int mobility = countBits(getMobility(player, opponent)) -
+                   countBits(getMobility(opponent, player));
+    int potentialMobility = countBits(getNeighbours(opponent) & empty) -
+                            countBits(getNeighbours(player) & empty);
+    int corners = countBits(player & CORNERS) - countBits(opponent & CORNERS);
+    int discs = countBits(player) - countBits(opponent);
+
+    // Las casillas X y C solo son peligrosas mientras su esquina está vacía
+    Bitboard xSquares = 0;
+    Bitboard cSquares = 0;
+    for (const CornerSquares &squares : cornerSquares)
+    {
+        if (empty & squares.corner)
+        {
+            xSquares |= squares.xSquare;
+            cSquares |= squares.cSquares;
+        }
+    }
+    int xSquareCount = countBits(player & xSquares) - countBits(opponent & xSquares);
+    int cSquareCount = countBits(player & cSquares) - countBits(opponent & cSquares);
+
+    const HeuristicWeights &opening = openingWeights;
+    const HeuristicWeights &endgame = endgameWeights;
+    int openingScore = opening.mobility * mobility +
+                       opening.potentialMobility * potentialMobility +
+                       opening.corners * corners +
+                       opening.xSquares * xSquareCount +
+                       opening.cSquares * cSquareCount +
+                       opening.discs * discs;
+    int endgameScore = endgame.mobility * mobility +
+                       endgame.potentialMobility * potentialMobility +
+                       endgame.corners * corners +
+                       endgame.xSquares * xSquareCount +
+                       endgame.cSquares * cSquareCount +
+                       endgame.discs * discs;
+
+    int score = (openingScore * emptyCount + endgameScore * (OPENING_EMPTIES - emptyCount)) /
+                OPENING_EMPTIES;
+
+    return score / HEURISTIC_SCALE;
+}
@@ -0,0 +1,25 @@
+/**
+ * @brief Implements the AI's heuristic evaluation
+ *
+ * @copyright Copyright (c) 2023-2024
+ */
+
+#ifndef HEURISTIC_H
+#define HEURISTIC_H
+
+#include "bitboard.h"
+
+/**
+ * @brief Evaluates a position from its structure.
+ *
+ * Weighs mobility, potential mobility, corners and the X and C squares
+ * next to empty corners, with weights that change from the opening to
+ * the endgame.
+ *
+ * @param position The position.
+ * @param emptyCount The number of empty squares.
+ * @return The evaluation, in discs, from the side to move's point of view.
+ */
+int evaluateHeuristic(Position &position, int emptyCount);
+
+#endif
@@ -5,14 +5,32 @@
  * @copyright Copyright (c) 2023-2024
  */
 
+#include "aiservice.h"
+#include "book.h"
 #include "model.h"
+#include "pattern.h"
+#include "trace.h"
 #include "view.h"
 #include "controller.h"
 
+#define PATTERN_WEIGHTS_FILE "edaversi.weights"
+#define BOOK_FILE "edaversi.book"
+#define SEARCH_LOG_FILE "edaversi.search.jsonl"
+#define TRACE_FILE "edaversi.trace.json"
+
 int main()
 {
     GameModel model;
 
+    TRACE_THREAD_NAME("main");
+
+    // Without a weights file, the AI uses its heuristic evaluation
+    loadPatternWeights(PATTERN_WEIGHTS_FILE);
+    // Without a book file, the AI searches its opening moves too
+    loadBook(BOOK_FILE);
+    // One JSON line of search statistics per AI move
+    openSearchLog(SEARCH_LOG_FILE);
+
     initModel(model);
     initView();
 
@@ -20,4 +38,15 @@ int main()
         ;
 
     freeView();
+
+    // The AI's threads must be idle before the trace is written
+    stopBestMoveSearch();
+
+#ifdef EDAVERSI_TRACE
+    // Open in chrome://tracing or ui.perfetto.dev
+    writeTrace(TRACE_FILE);
+#endif
+    closeSearchLog();
+    freeBook();
+    freePatternWeights();
 }
@@ -0,0 +1,195 @@
+/**
+ * @brief Builds the opening book
+ *
+ * Usage: edaversi_book [plies [depth [output]]]
+ *
+ * Searches every move of the initial position to a fixed depth, then
+ * does the same for the positions reached by the moves within a few
+ * discs of the best one, up to a number of plies. Symmetric positions
+ * are searched once. Each book move counts the book positions at and
+ * below the position it leads to. The search uses edaversi.weights if
+ * present.
+ *
+ * @copyright Copyright (c) 2023-2024
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "ai.h"
+#include "book.h"
+#include "pattern.h"
+#include "symmetry.h"
+
+#define DEFAULT_PLIES 8
+#define DEFAULT_DEPTH 8
+#define DEFAULT_OUTPUT "edaversi.book"
+#define PATTERN_WEIGHTS_FILE "edaversi.weights"
+
+// Se siguen las jugadas que pierden a lo sumo estas fichas contra la mejor
+#define BOOK_EXPAND_MARGIN 4
+
+/**
+ * @brief A position waiting to be added to the book.
+ */
+struct BookNode
+{
+    GameModel model;
+    int ply;
+    uint64_t parentKey; // Clave de la posición desde la que se llegó
+};
+
+/**
+ * @brief Returns a position's value for a player, searched to a depth.
+ *
+ * @param model The game model.
+ * @param player The player.
+ * @param depth The search depth.
+ * @param limits The search limits.
+ * @return The value, in discs.
+ */
+static int searchScore(GameModel model, Player player, int depth, SearchLimits &limits)
+{
+    while (!model.gameOver)
+    {
+        Moves validMoves;
+        getValidMoves(model, validMoves);
+
+        // Con una sola jugada getBestMove no busca: se juega y se sigue
+        if (validMoves.size() > 1)
+        {
+            limits.maxDepth = std::max(depth, 1);
+
+            SearchInfo info;
+            getBestMove(model, limits, info);
+
+            return (model.currentPlayer == player) ? info.score : -info.score;
+        }
+
+        playMove(model, validMoves[0]);
+        depth--;
+    }
+
+    Position position = getPosition(model);
+    int score = getFinalScore(position);
+
+    return (model.currentPlayer == player) ? score : -score;
+}
+
+int main(int argc, char *argv[])
+{
+    int plies = (argc > 1) ? atoi(argv[1]) : DEFAULT_PLIES;
+    int depth = (argc > 2) ? atoi(argv[2]) : DEFAULT_DEPTH;
+    const char *output = (argc > 3) ? argv[3] : DEFAULT_OUTPUT;
+
+    if (loadPatternWeights(PATTERN_WEIGHTS_FILE))
+        printf("Searching with %s\n", PATTERN_WEIGHTS_FILE);
+
+    SearchLimits limits;
+    initSearchLimits(limits);
+    limits.gameTime = 1e9;
+    limits.useBook = false;
+
+    std::vector<BookEntry> entries;
+    std::vector<uint64_t> childKeys; // Clave de la posición a la que lleva cada entrada
+    std::unordered_set<uint64_t> bookKeys;
+    // Posiciones en el orden en que entraron, con la posición desde la que se llegó
+    std::vector<std::pair<uint64_t, uint64_t>> bookTree;
+    std::deque<BookNode> nodes;
+
+    BookNode root;
+    initModel(root.model);
+    startModel(root.model);
+    root.ply = 0;
+    root.parentKey = 0;
+    nodes.push_back(root);
+
+    double startTime = getClockTime();
+    while (!nodes.empty())
+    {
+        BookNode node = nodes.front();
+        nodes.pop_front();
+
+        Position position = getPosition(node.model);
+        int symmetry;
+        uint64_t key = getBookKey(position, symmetry);
+        if (!bookKeys.insert(key).second)
+            continue;
+        bookTree.push_back({key, node.parentKey});
+
+        Moves validMoves;
+        getValidMoves(node.model, validMoves);
+
+        std::vector<int> scores;
+        int bestScore = -BOARD_SIZE * BOARD_SIZE;
+        for (Square move : validMoves)
+        {
+            GameModel child = node.model;
+            playMove(child, move);
+
+            Position childPosition = getPosition(child);
+            int childSymmetry;
+            childKeys.push_back(getBookKey(childPosition, childSymmetry));
+
+            int score = searchScore(child, node.model.currentPlayer, depth - 1, limits);
+            scores.push_back(score);
+            bestScore = std::max(bestScore, score);
+
+            BookEntry entry = {};
+            entry.key = key;
+            entry.score = (int16_t)score;
+            entry.move = (uint8_t)transformSquare(getSquareIndex(move), symmetry);
+            entry.depth = (uint8_t)depth;
+            entries.push_back(entry);
+        }
+
+        for (int i = 0; i < validMoves.size(); i++)
+        {
+            if ((node.ply + 1 >= plies) || (scores[i] < bestScore - BOOK_EXPAND_MARGIN))
+                continue;
+
+            BookNode child = {node.model, node.ply + 1, key};
+            playMove(child.model, validMoves[i]);
+            if (!child.model.gameOver)
+                nodes.push_back(child);
+        }
+
+        printf("\r%zu positions, %zu entries, %zu queued, %.0f s",
+               bookKeys.size(),
+               entries.size(),
+               nodes.size(),
+               getClockTime() - startTime);
+        fflush(stdout);
+    }
+    printf("\n");
+
+    // Del final hacia la raíz, cada posición suma su subárbol al de la que la
+    // descubrió; así las jugadas simétricas y las transposiciones cuentan igual
+    std::unordered_map<uint64_t, uint32_t> subtreeSizes;
+    for (size_t i = bookTree.size(); i-- > 0;)
+    {
+        uint32_t size = ++subtreeSizes[bookTree[i].first];
+        if (i > 0)
+            subtreeSizes[bookTree[i].second] += size;
+    }
+    for (size_t i = 0; i < entries.size(); i++)
+    {
+        auto subtreeSize = subtreeSizes.find(childKeys[i]);
+        if (subtreeSize != subtreeSizes.end())
+            entries[i].count = subtreeSize->second;
+    }
+
+    if (!saveBook(output, entries))
+    {
+        fprintf(stderr, "Could not write %s\n", output);
+        return 1;
+    }
+    printf("Wrote %s\n", output);
+
+    return 0;
+}
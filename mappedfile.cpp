@@ -0,0 +1,95 @@
+/**
+ * @brief Implements read-only memory-mapped files
+ *
+ * @copyright Copyright (c) 2023-2024
+ */
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "mappedfile.h"
+
+bool mapFile(const char *path, MappedFile &mappedFile)
+{
+    mappedFile.data = nullptr;
+    mappedFile.size = 0;
+    mappedFile.file = nullptr;
+    mappedFile.mapping = nullptr;
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, 0, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER fileSize;
+    HANDLE mapping = nullptr;
+    const void *data = nullptr;
+    if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart)
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping)
+        data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+
+    if (!data)
+    {
+        if (mapping)
+            CloseHandle(mapping);
+        CloseHandle(file);
+
+        return false;
+    }
+
+    mappedFile.data = data;
+    mappedFile.size = (size_t)fileSize.QuadPart;
+    mappedFile.file = file;
+    mappedFile.mapping = mapping;
+#else
+    int file = open(path, O_RDONLY);
+    if (file < 0)
+        return false;
+
+    struct stat fileStat;
+    const void *data = nullptr;
+    if ((fstat(file, &fileStat) == 0) && fileStat.st_size)
+    {
+        data = mmap(nullptr, (size_t)fileStat.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+        if (data == MAP_FAILED)
+            data = nullptr;
+    }
+
+    // El mapeo sigue válido después de cerrar el archivo
+    close(file);
+
+    if (!data)
+        return false;
+
+    mappedFile.data = data;
+    mappedFile.size = (size_t)fileStat.st_size;
+#endif
+
+    return true;
+}
+
+void unmapFile(MappedFile &mappedFile)
+{
+    if (!mappedFile.data)
+        return;
+
+#ifdef _WIN32
+    UnmapViewOfFile(mappedFile.data);
+    CloseHandle(mappedFile.mapping);
+    CloseHandle(mappedFile.file);
+#else
+    munmap((void *)mappedFile.data, mappedFile.size);
+#endif
+
+    mappedFile.data = nullptr;
+    mappedFile.size = 0;
+    mappedFile.file = nullptr;
+    mappedFile.mapping = nullptr;
+}
@@ -0,0 +1,41 @@
+/**
+ * @brief Implements read-only memory-mapped files
+ *
+ * @copyright Copyright (c) 2023-2024
+ */
+
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <cstddef>
+
+/**
+ * @brief A file mapped into memory.
+ */
+struct MappedFile
+{
+    const void *data; // Nulo si no hay archivo mapeado
+    size_t size;
+
+    // Recursos del sistema (en Windows, el archivo y el mapeo)
+    void *file;
+    void *mapping;
+};
+
+/**
+ * @brief Maps a whole file into memory, read-only.
+ *
+ * @param path The path of the file.
+ * @param mappedFile Receives the mapping.
+ * @return The file was mapped.
+ */
+bool mapFile(const char *path, MappedFile &mappedFile);
+
+/**
+ * @brief Unmaps a file mapped with mapFile. Does nothing if none is mapped.
+ *
+ * @param mappedFile The mapping.
+ */
+void unmapFile(MappedFile &mappedFile);
+
+#endif
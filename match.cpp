@@ -0,0 +1,590 @@
+/**
+ * @brief Plays games between two engine configurations
+ *
+ * Usage: edaversi_match [options]
+ *
+ *   -a SPEC, -b SPEC  Engine configurations, as comma-separated
+ *                     key=value pairs: depth, nodes (per move), eval
+ *                     (discs, heuristic or patterns), time (seconds per
+ *                     game, 0 for no clock) and book (0 or 1).
+ *                     Default: depth=8,nodes=0,eval=patterns,time=0,book=0
+ *   -games N          Number of games (default 100), played in pairs
+ *                     from the same opening with colours swapped.
+ *   -threads N        Games played at once (default: hardware threads).
+ *   -openings FILE    Openings, one per line as moves ("f5d6c3..."). By
+ *                     default, openings of random moves are used.
+ *   -plies N          Moves of the random openings (default 8).
+ *   -seed N           Seed of the random openings and of the book's
+ *                     choices (default 1).
+ *   -sprt ELO0 ELO1   Stop when a sequential probability ratio test
+ *                     (alpha = beta = 0.05) decides between ELO0 and ELO1.
+ *   -weights FILE     Pattern weights (default edaversi.weights).
+ *   -book FILE        Opening book (default edaversi.book).
+ *   -trace FILE       Writes the trace events of the match (Chrome
+ *                     trace event format; needs EDAVERSI_TRACE).
+ *
+ * Each search uses one thread. With a clock, play as many games at once
+ * as there are cores, or the engines run slower than they would alone.
+ * Each engine has its own transposition table in each game thread,
+ * emptied before every game, so without a clock a match gives the same
+ * results with any number of threads.
+ *
+ * @copyright Copyright (c) 2023-2024
+ */
+
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "ai.h"
+#include "book.h"
+#include "pattern.h"
+#include "threadpool.h"
+#include "trace.h"
+#include "transposition.h"
+
+#define DEFAULT_GAMES 100
+#define DEFAULT_OPENING_PLIES 8
+#define DEFAULT_DEPTH 8
+#define DEFAULT_SEED 1
+// 2^19 entradas (8 MB) por motor y por hilo
+#define MATCH_TABLE_BITS 19
+#define PATTERN_WEIGHTS_FILE "edaversi.weights"
+#define BOOK_FILE "edaversi.book"
+
+// Sin reloj, cada jugador tiene este tiempo: nunca se acaba
+#define UNLIMITED_TIME 1e9
+
+// Errores de tipo I y II del SPRT
+#define SPRT_ALPHA 0.05
+#define SPRT_BETA 0.05
+
+// Intervalo de confianza del 95%
+#define CONFIDENCE_Z 1.96
+
+/**
+ * @brief An engine configuration and its statistics.
+ */
+struct MatchEngine
+{
+    SearchLimits limits;
+
+    double time;
+    uint64_t nodes;
+    int moves;
+    int timeForfeits;
+};
+
+/**
+ * @brief The state of a match, shared by the game threads.
+ */
+struct Match
+{
+    MatchEngine engines[2];
+    std::vector<GameModel> openings;
+    int gameCount;
+    uint64_t seed;
+
+    bool sprt;
+    double elo0;
+    double elo1;
+
+    std::atomic<int> nextGame;
+    std::atomic<bool> stop;
+
+    std::mutex mutex; // Protege lo que sigue y las estadísticas de los motores
+    int wins;         // Del motor A
+    int draws;
+    int losses;
+    const char *sprtResult;
+};
+
+/**
+ * @brief Returns a pseudo-random number.
+ *
+ * @param seed The generator state.
+ * @return The number.
+ */
+static uint32_t getRandom(uint64_t &seed)
+{
+    seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+
+    return (uint32_t)(seed >> 33);
+}
+
+/**
+ * @brief Reads an engine configuration.
+ *
+ * @param spec The configuration, as key=value pairs.
+ * @param engine Receives the configuration.
+ * @return The configuration is valid.
+ */
+static bool readEngine(const char *spec, MatchEngine &engine)
+{
+    std::string options = spec;
+    size_t start = 0;
+    while (start < options.size())
+    {
+        size_t end = options.find(',', start);
+        if (end == std::string::npos)
+            end = options.size();
+
+        std::string option = options.substr(start, end - start);
+        start = end + 1;
+
+        size_t equals = option.find('=');
+        if (equals == std::string::npos)
+            return false;
+
+        std::string key = option.substr(0, equals);
+        std::string value = option.substr(equals + 1);
+        SearchLimits &limits = engine.limits;
+
+        if (key == "depth")
+            limits.maxDepth = atoi(value.c_str());
+        else if (key == "nodes")
+            limits.maxNodes = strtoull(value.c_str(), nullptr, 10);
+        else if (key == "time")
+            limits.gameTime = (atof(value.c_str()) > 0) ? atof(value.c_str()) : UNLIMITED_TIME;
+        else if (key == "book")
+            limits.useBook = atoi(value.c_str()) != 0;
+        else if ((key == "eval") && (value == "discs"))
+            limits.evaluator = EVALUATOR_DISCS;
+        else if ((key == "eval") && (value == "heuristic"))
+            limits.evaluator = EVALUATOR_HEURISTIC;
+        else if ((key == "eval") && (value == "patterns"))
+            limits.evaluator = EVALUATOR_PATTERNS;
+        else
+            return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Plays moves given as text ("f5d6...") from the initial position.
+ *
+ * @param moves The moves.
+ * @param model Receives the position.
+ * @return The moves are valid.
+ */
+static bool readOpening(const char *moves, GameModel &model)
+{
+    initModel(model);
+    startModel(model);
+
+    for (; (moves[0] >= 'a') && (moves[0] <= 'h') && (moves[1] >= '1') && (moves[1] <= '8'); moves += 2)
+    {
+        Square move = {moves[0] - 'a', moves[1] - '1'};
+
+        Moves validMoves;
+        getValidMoves(model, validMoves);
+
+        bool valid = false;
+        for (Square validMove : validMoves)
+            valid |= (validMove.x == move.x) && (validMove.y == move.y);
+        if (!valid || model.gameOver)
+            return false;
+
+        playMove(model, move);
+    }
+
+    return !model.gameOver;
+}
+
+/**
+ * @brief Returns the Elo difference that gives an expected score.
+ *
+ * @param score The expected score, between 0 and 1.
+ * @return The Elo difference.
+ */
+static double getElo(double score)
+{
+    score = std::min(std::max(score, 1e-6), 1 - 1e-6);
+
+    return 400 * log10(score / (1 - score));
+}
+
+/**
+ * @brief Returns the expected score of an Elo difference.
+ *
+ * @param elo The Elo difference.
+ * @return The expected score, between 0 and 1.
+ */
+static double getExpectedScore(double elo)
+{
+    return 1 / (1 + pow(10, -elo / 400));
+}
+
+/**
+ * @brief Returns the mean and the variance of the results of engine A.
+ *
+ * @param match The match.
+ * @param variance Receives the variance of one game's result.
+ * @return The mean result (1 a win, 0.5 a draw, 0 a loss).
+ */
+static double getMatchScore(Match &match, double &variance)
+{
+    int games = match.wins + match.draws + match.losses;
+    double score = (match.wins + 0.5 * match.draws) / games;
+
+    variance = (match.wins * (1 - score) * (1 - score) +
+                match.draws * (0.5 - score) * (0.5 - score) +
+                match.losses * score * score) /
+               games;
+
+    return score;
+}
+
+/**
+ * @brief Returns the log-likelihood ratio of the SPRT between elo0 and elo1.
+ *
+ * Uses the normal approximation of the results' distribution.
+ *
+ * @param match The match.
+ * @return The log-likelihood ratio.
+ */
+static double getLogLikelihoodRatio(Match &match)
+{
+    int games = match.wins + match.draws + match.losses;
+    double variance;
+    double score = getMatchScore(match, variance);
+    if (variance <= 0)
+        return 0;
+
+    double score0 = getExpectedScore(match.elo0);
+    double score1 = getExpectedScore(match.elo1);
+
+    return games * (score1 - score0) * (2 * score - score0 - score1) / (2 * variance);
+}
+
+/**
+ * @brief Plays a game of the match.
+ *
+ * @param match The match.
+ * @param game The game's number: even games give black to engine A.
+ * @param tables The transposition tables of engines A and B.
+ */
+static void playMatchGame(Match &match, int game, TranspositionTable *tables[2])
+{
+    GameModel model = match.openings[(game / 2) % match.openings.size()];
+    model.playerTime[PLAYER_BLACK] = 0;
+    model.playerTime[PLAYER_WHITE] = 0;
+    model.turnTimer = getClockTime();
+
+    Player colourA = (game % 2) ? PLAYER_WHITE : PLAYER_BLACK;
+
+    // Cada partida empieza igual, la juegue el hilo que la juegue
+    clearTranspositionTable(tables[0]);
+    clearTranspositionTable(tables[1]);
+    uint64_t bookSeed = match.seed ^ ((uint64_t)(game + 1) * 0x9e3779b97f4a7c15ULL);
+
+    int result = 0; // Del motor A: 1 gana, 0 empata, -1 pierde
+    while (!model.gameOver && !match.stop)
+    {
+        Player player = model.currentPlayer;
+        int engineIndex = (player == colourA) ? 0 : 1;
+        MatchEngine &engine = match.engines[engineIndex];
+
+        SearchLimits limits = engine.limits;
+        limits.table = tables[engineIndex];
+        limits.bookSeed = &bookSeed;
+        SearchInfo info;
+        Square move = getBestMove(model, limits, info);
+        playMove(model, move);
+
+        bool forfeit = model.playerTime[player] > limits.gameTime;
+        {
+            std::lock_guard<std::mutex> lock(match.mutex);
+            engine.time += info.time;
+            engine.nodes += info.nodes;
+            engine.moves++;
+            engine.timeForfeits += forfeit;
+        }
+
+        // Quien se pasa de tiempo pierde
+        if (forfeit)
+        {
+            result = engineIndex ? 1 : -1;
+            break;
+        }
+    }
+
+    if (match.stop)
+        return;
+
+    if (model.gameOver)
+    {
+        Player colourB = getOpponent(colourA);
+        int discsA = countBits(model.discs[colourA]);
+        int discsB = countBits(model.discs[colourB]);
+        result = (discsA > discsB) - (discsA < discsB);
+    }
+
+    std::lock_guard<std::mutex> lock(match.mutex);
+    match.wins += (result > 0);
+    match.draws += (result == 0);
+    match.losses += (result < 0);
+
+    int games = match.wins + match.draws + match.losses;
+    double variance;
+    double score = getMatchScore(match, variance);
+    printf("\r%d games: +%d =%d -%d, score %.1f%%, Elo %+.1f",
+           games,
+           match.wins,
+           match.draws,
+           match.losses,
+           100 * score,
+           getElo(score));
+    fflush(stdout);
+
+    if (match.sprt && !match.sprtResult)
+    {
+        double llr = getLogLikelihoodRatio(match);
+        if (llr <= log(SPRT_BETA / (1 - SPRT_ALPHA)))
+            match.sprtResult = "H0 accepted";
+        else if (llr >= log((1 - SPRT_BETA) / SPRT_ALPHA))
+            match.sprtResult = "H1 accepted";
+
+        // Las partidas que faltan ya no cambian el resultado
+        if (match.sprtResult)
+            match.stop = true;
+    }
+}
+
+/**
+ * @brief Prints an engine's configuration.
+ *
+ * @param name The engine's name.
+ * @param engine The engine.
+ */
+static void printEngineConfig(const char *name, MatchEngine &engine)
+{
+    static const char *evaluatorNames[] = {"discs", "heuristic", "patterns"};
+    SearchLimits &limits = engine.limits;
+
+    printf("%s: depth %d, nodes %llu, eval %s, ",
+           name,
+           limits.maxDepth,
+           (unsigned long long)limits.maxNodes,
+           evaluatorNames[limits.evaluator]);
+    if (limits.gameTime < UNLIMITED_TIME)
+        printf("time %g s, ", limits.gameTime);
+    else
+        printf("no clock, ");
+    printf("book %s\n", limits.useBook ? "on" : "off");
+}
+
+/**
+ * @brief Prints an engine's statistics.
+ *
+ * @param name The engine's name.
+ * @param engine The engine.
+ */
+static void printEngine(const char *name, MatchEngine &engine)
+{
+    int moves = std::max(engine.moves, 1);
+
+    printf("%s: %.1f ms/move, %.0f nodes/move, %.2fM nodes/s",
+           name,
+           1000 * engine.time / moves,
+           (double)engine.nodes / moves,
+           engine.time ? engine.nodes / engine.time / 1e6 : 0.0);
+    if (engine.timeForfeits)
+        printf(", %d losses on time", engine.timeForfeits);
+    printf("\n");
+}
+
+int main(int argc, char *argv[])
+{
+    Match match;
+    match.gameCount = DEFAULT_GAMES;
+    match.seed = DEFAULT_SEED;
+    match.sprt = false;
+    match.elo0 = 0;
+    match.elo1 = 0;
+    match.nextGame = 0;
+    match.stop = false;
+    match.wins = 0;
+    match.draws = 0;
+    match.losses = 0;
+    match.sprtResult = nullptr;
+
+    for (MatchEngine &engine : match.engines)
+    {
+        initSearchLimits(engine.limits);
+        engine.limits.maxDepth = DEFAULT_DEPTH;
+        engine.limits.gameTime = UNLIMITED_TIME;
+        engine.limits.threadCount = 1;
+        engine.limits.useBook = false;
+        engine.time = 0;
+        engine.nodes = 0;
+        engine.moves = 0;
+        engine.timeForfeits = 0;
+    }
+    int threadCount = getHardwareThreadCount();
+    int openingPlies = DEFAULT_OPENING_PLIES;
+    const char *openingsPath = nullptr;
+    const char *weightsPath = PATTERN_WEIGHTS_FILE;
+    const char *bookPath = BOOK_FILE;
+    const char *tracePath = nullptr;
+
+    for (int i = 1; i < argc; i++)
+    {
+        bool hasValue = (i + 1 < argc);
+
+        if (!strcmp(argv[i], "-a") && hasValue && readEngine(argv[i + 1], match.engines[0]))
+            i++;
+        else if (!strcmp(argv[i], "-b") && hasValue && readEngine(argv[i + 1], match.engines[1]))
+            i++;
+        else if (!strcmp(argv[i], "-games") && hasValue)
+            match.gameCount = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-threads") && hasValue)
+            threadCount = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-openings") && hasValue)
+            openingsPath = argv[++i];
+        else if (!strcmp(argv[i], "-plies") && hasValue)
+            openingPlies = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-seed") && hasValue)
+            match.seed = strtoull(argv[++i], nullptr, 10);
+        else if (!strcmp(argv[i], "-sprt") && (i + 2 < argc))
+        {
+            match.sprt = true;
+            match.elo0 = atof(argv[++i]);
+            match.elo1 = atof(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "-weights") && hasValue)
+            weightsPath = argv[++i];
+        else if (!strcmp(argv[i], "-book") && hasValue)
+            bookPath = argv[++i];
+        else if (!strcmp(argv[i], "-trace") && hasValue)
+            tracePath = argv[++i];
+        else
+        {
+            fprintf(stderr, "Invalid option: %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    loadPatternWeights(weightsPath);
+    loadBook(bookPath);
+
+    if (openingsPath)
+    {
+        FILE *file = fopen(openingsPath, "r");
+        if (!file)
+        {
+            fprintf(stderr, "Could not open %s\n", openingsPath);
+            return 1;
+        }
+
+        char line[256];
+        while (fgets(line, sizeof(line), file))
+        {
+            GameModel opening;
+            if (readOpening(line, opening))
+                match.openings.push_back(opening);
+        }
+
+        fclose(file);
+    }
+    else
+    {
+        uint64_t seed = match.seed;
+        for (int i = 0; i < (match.gameCount + 1) / 2; i++)
+        {
+            GameModel opening;
+            do
+            {
+                initModel(opening);
+                startModel(opening);
+                for (int ply = 0; (ply < openingPlies) && !opening.gameOver; ply++)
+                {
+                    Moves validMoves;
+                    getValidMoves(opening, validMoves);
+                    playMove(opening, validMoves[getRandom(seed) % validMoves.size()]);
+                }
+            } while (opening.gameOver);
+
+            match.openings.push_back(opening);
+        }
+    }
+    if (match.openings.empty())
+    {
+        fprintf(stderr, "No openings\n");
+        return 1;
+    }
+
+    printEngineConfig("A", match.engines[0]);
+    printEngineConfig("B", match.engines[1]);
+    printf("%d games, %zu openings, %d threads\n", match.gameCount, match.openings.size(), threadCount);
+
+    double startTime = getClockTime();
+    runThreadPool(threadCount, [&](int) {
+        TranspositionTable *tables[2] = {createTranspositionTable(MATCH_TABLE_BITS),
+                                         createTranspositionTable(MATCH_TABLE_BITS)};
+
+        for (int game = match.nextGame++; (game < match.gameCount) && !match.stop; game = match.nextGame++)
+            playMatchGame(match, game, tables);
+
+        freeTranspositionTable(tables[0]);
+        freeTranspositionTable(tables[1]);
+    });
+    printf("\n");
+
+    int games = match.wins + match.draws + match.losses;
+    if (!games)
+        return 1;
+
+    // El intervalo de Elo sale del intervalo del puntaje medio
+    double variance;
+    double score = getMatchScore(match, variance);
+    double margin = CONFIDENCE_Z * sqrt(variance / games);
+    double elo = getElo(score);
+    double eloLow = getElo(score - margin);
+    double eloHigh = getElo(score + margin);
+
+    printf("A vs B: +%d =%d -%d in %.0f s\n",
+           match.wins,
+           match.draws,
+           match.losses,
+           getClockTime() - startTime);
+    printf("Score of A: %.1f%% +/- %.1f%%, Elo %+.1f (%+.1f, %+.1f) at 95%%\n",
+           100 * score,
+           100 * margin,
+           elo,
+           eloLow,
+           eloHigh);
+    if (match.sprt)
+        printf("SPRT [%g, %g]: LLR %.2f (%.2f, %.2f), %s\n",
+               match.elo0,
+               match.elo1,
+               getLogLikelihoodRatio(match),
+               log(SPRT_BETA / (1 - SPRT_ALPHA)),
+               log((1 - SPRT_BETA) / SPRT_ALPHA),
+               match.sprtResult ? match.sprtResult : "inconclusive");
+    printEngine("A", match.engines[0]);
+    printEngine("B", match.engines[1]);
+
+    if (tracePath)
+    {
+#ifdef EDAVERSI_TRACE
+        if (writeTrace(tracePath))
+            printf("Wrote %s\n", tracePath);
+        else
+            fprintf(stderr, "Could not write %s\n", tracePath);
+#else
+        fprintf(stderr, "Built without EDAVERSI_TRACE: no trace events\n");
+#endif
+    }
+
+    freeBook();
+    freePatternWeights();
+
+    return 0;
+}
@@ -5,9 +5,9 @@
  * @copyright Copyright (c) 2023-2024
  */
 
-#include <raylib.h>
+#include <chrono>
 
-#include "model.h" 
+#include "model.h"
 
 void initModel(GameModel &model)
 {
@@ -16,7 +16,8 @@ void initModel(GameModel &model)
     model.playerTime[0] = 0;
     model.playerTime[1] = 0;
 
-    memset(model.board, PIECE_EMPTY, sizeof(model.board));
+    model.discs[PLAYER_BLACK] = 0;
+    model.discs[PLAYER_WHITE] = 0;
 }
 
 void startModel(GameModel &model)
@@ -27,13 +28,21 @@ void startModel(GameModel &model)
 
     model.playerTime[0] = 0;
     model.playerTime[1] = 0;
-    model.turnTimer = GetTime();
+    model.turnTimer = getClockTime();
+
+    model.discs[PLAYER_BLACK] = 0;
+    model.discs[PLAYER_WHITE] = 0;
+    setBoardPiece(model, {BOARD_SIZE / 2 - 1, BOARD_SIZE / 2 - 1}, PIECE_WHITE);
+    setBoardPiece(model, {BOARD_SIZE / 2, BOARD_SIZE / 2 - 1}, PIECE_BLACK);
+    setBoardPiece(model, {BOARD_SIZE / 2, BOARD_SIZE / 2}, PIECE_WHITE);
+    setBoardPiece(model, {BOARD_SIZE / 2 - 1, BOARD_SIZE / 2}, PIECE_BLACK);
+}
+
+double getClockTime()
+{
+    using namespace std::chrono;
 
-    memset(model.board, PIECE_EMPTY, sizeof(model.board));
-    model.board[BOARD_SIZE / 2 - 1][BOARD_SIZE / 2 - 1] = PIECE_WHITE;
-    model.board[BOARD_SIZE / 2 - 1][BOARD_SIZE / 2] = PIECE_BLACK;
-    model.board[BOARD_SIZE / 2][BOARD_SIZE / 2] = PIECE_WHITE;
-    model.board[BOARD_SIZE / 2][BOARD_SIZE / 2 - 1] = PIECE_BLACK;
+    return duration<double>(steady_clock::now().time_since_epoch()).count();
 }
 
 Player getCurrentPlayer(GameModel &model)
@@ -43,19 +52,7 @@ Player getCurrentPlayer(GameModel &model)
 
 int getScore(GameModel &model, Player player)
 {
-    int score = 0;
-
-    for (int y = 0; y < BOARD_SIZE; y++)
-        for (int x = 0; x < BOARD_SIZE; x++)
-        {
-            if (((model.board[y][x] == PIECE_WHITE) &&
-                 (player == PLAYER_WHITE)) ||
-                ((model.board[y][x] == PIECE_BLACK) &&
-                 (player == PLAYER_BLACK)))
-                score++;
-        }
-
-    return score;
+    return countBits(model.discs[player]);
 }
 
 double getTimer(GameModel &model, Player player)
@@ -63,19 +60,52 @@ double getTimer(GameModel &model, Player player)
     double turnTime = 0;
 
     if (!model.gameOver && (player == model.currentPlayer))
-        turnTime = GetTime() - model.turnTimer;
+        turnTime = getClockTime() - model.turnTimer;
 
     return model.playerTime[player] + turnTime;
 }
 
 Piece getBoardPiece(GameModel &model, Square square)
 {
-    return model.board[square.y][square.x];
+    Bitboard bit = 1ULL << getSquareIndex(square);
+
+    if (model.discs[PLAYER_BLACK] & bit)
+        return PIECE_BLACK;
+    else if (model.discs[PLAYER_WHITE] & bit)
+        return PIECE_WHITE;
+    else
+        return PIECE_EMPTY;
 }
 
 void setBoardPiece(GameModel &model, Square square, Piece piece)
 {
-    model.board[square.y][square.x] = piece;
+    Bitboard bit = 1ULL << getSquareIndex(square);
+
+    model.discs[PLAYER_BLACK] &= ~bit;
+    model.discs[PLAYER_WHITE] &= ~bit;
+
+    if (piece == PIECE_BLACK)
+        model.discs[PLAYER_BLACK] |= bit;
+    else if (piece == PIECE_WHITE)
+        model.discs[PLAYER_WHITE] |= bit;
+}
+
+Position getPosition(GameModel &model)
+{
+    Player player = getCurrentPlayer(model);
+    Player opponent = getOpponent(player);
+
+    return {model.discs[player], model.discs[opponent]};
+}
+
+int getSquareIndex(Square square)
+{
+    return square.y * BOARD_SIZE + square.x;
+}
+
+Square getIndexSquare(int index)
+{
+    return {index % BOARD_SIZE, index / BOARD_SIZE};
 }
 
 bool isSquareValid(Square square)
@@ -88,601 +118,45 @@ bool isSquareValid(Square square)
 
 void getValidMoves(GameModel &model, Moves &validMoves)
 {
+    Position position = getPosition(model);
 
-    Player player = getCurrentPlayer(model);
-    //bool adyascencia;
-    bool alineado;
-    std::vector<Square> direcciones = {{1,0},{0,1},{-1,0},{0,-1},{1,1},{-1,1},{-1,-1},{1,-1}};
-
-
-    for (int y = 0; y < BOARD_SIZE; y++)
-        for (int x = 0; x < BOARD_SIZE; x++)
-        {
-            Square move = {x, y};
-            
-            alineado = false;
-            
-            if (getBoardPiece(model, move) == PIECE_EMPTY)
-            {
-                Square moveAux;
-
-                if(player == PLAYER_BLACK)
-                {
-                        for(auto& direccion : direcciones)
-                        {
-                            bool oponenteEncontrado = false;
-                            moveAux = move;
-                            moveAux.x += direccion.x;
-                            moveAux.y += direccion.y;
-                            while(isSquareValid(moveAux))
-                            {
-                                if(getBoardPiece(model,moveAux) == PIECE_WHITE)
-                                {
-                                    oponenteEncontrado = true;
-                                }else if(getBoardPiece(model,moveAux) == PIECE_BLACK && oponenteEncontrado)
-                                {
-                                    alineado = true;
-                                    break;
-                                }
-                                else
-                                {
-                                    break;
-                                }
-                                moveAux.x += direccion.x;
-                                moveAux.y += direccion.y;
-                            }
-                            if(alineado)
-                            {
-                                validMoves.push_back(move);
-                                break;
-                            }
-                        }
-                    
-                }else
-                {
-                        for(auto& direccion : direcciones)
-                        {
-                            bool oponenteEncontrado = false;
-                            moveAux = move;
-                            moveAux.x += direccion.x;
-                            moveAux.y += direccion.y;
-                            while(isSquareValid(moveAux))
-                            {
-                                if(getBoardPiece(model,moveAux) == PIECE_BLACK)
-                                {
-                                    oponenteEncontrado = true;
-                                }else if(getBoardPiece(model,moveAux) == PIECE_WHITE && oponenteEncontrado)
-                                {
-                                    alineado = true;
-                                    break;
-                                }
-                                else
-                                {
-                                    break;
-                                }
-                                moveAux.x += direccion.x;
-                                moveAux.y += direccion.y;
-                            }
-                            if(alineado)
-                            {
-                                validMoves.push_back(move);
-                                break;
-                            }
-                        }
-                    
-                }
-            }
-        }
+    getBitboardMoves(getMobility(position.player, position.opponent), validMoves);
+}
 
+void getBitboardMoves(Bitboard moves, Moves &validMoves)
+{
+    // Los bits salen en orden de filas, igual que el recorrido y, x
+    for (; moves; moves &= moves - 1)
+        validMoves.push_back(getIndexSquare(getFirstBit(moves)));
 }
 
 bool playMove(GameModel &model, Square move)
 {
-    bool terminar = 0;
-    bool propia = 0;
-
-    // Set game piece
-    Piece piece =
-        (getCurrentPlayer(model) == PLAYER_WHITE)
-            ? PIECE_WHITE
-            : PIECE_BLACK;
-
-    setBoardPiece(model, move, piece);
-
-    // cambio de color las intermedias 
-
-    // a la derecha
-    for (int x = 1; x < BOARD_SIZE && terminar == 0; x++) {
-        Square pos = {move.x + x, move.y};
-
-        if (getCurrentPlayer(model) == PLAYER_WHITE) {
-
-            if (isSquareValid(pos)) {
-                // Si encuentra una casilla vacía, termina el ciclo
-                if (getBoardPiece(model, pos) == PIECE_EMPTY)
-                    break;
-
-                if (getBoardPiece(model, pos) == PIECE_BLACK)
-                    continue;
-
-                // Si encuentra una pieza negra, verifica si ya había una pieza blanca al otro lado
-                if (getBoardPiece(model, pos) == PIECE_WHITE) {
-                    
-                    // Cambiar de color las del medio
-                    for (int i = 1; i < x; i++) {
-                        Square intermedia = {move.x + i, move.y};
-                        setBoardPiece(model, intermedia, PIECE_WHITE); // Cambia las piezas negras a blancas
-                    }
-                    break;  // Termina el ciclo
-                    
-                }
-
-            } else {
-                // Si la casilla no es válida, termina
-                break;
-            }
-
-        } else { // Caso de que el jugador actual sea negro
-            if (isSquareValid(pos)) {
-                // Si encuentra una casilla vacía, termina el ciclo
-                if (getBoardPiece(model, pos) == PIECE_EMPTY)
-                    break;
-
-                if (getBoardPiece(model, pos) == PIECE_WHITE)
-                    continue;
-
-                // Si encuentra una pieza negra, verifica si ya había una pieza blanca al otro lado
-                if (getBoardPiece(model, pos) == PIECE_BLACK) {
-                    
-                    // Cambiar de color las del medio
-                    for (int i = 1; i < x; i++) {
-                        Square intermedia = {move.x + i, move.y};
-                        setBoardPiece(model, intermedia, PIECE_BLACK); // Cambia las piezas negras a blancas
-                    }
-                    break;  // Termina el ciclo
-                    
-                }
-
-            } else {
-                // Si la casilla no es válida, termina
-                break;
-            }
-        }
-    }
-    // a la izquierda
-    for (int x = 1; x < BOARD_SIZE && terminar == 0; x++) {
-        Square pos = {move.x - x, move.y};
-
-        if (getCurrentPlayer(model) == PLAYER_WHITE) {
-
-            if (isSquareValid(pos)) {
-                // Si encuentra una casilla vacía, termina el ciclo
-                if (getBoardPiece(model, pos) == PIECE_EMPTY)
-                    break;
-
-                if (getBoardPiece(model, pos) == PIECE_BLACK)
-                    continue;
-
-                // Si encuentra una pieza negra, verifica si ya había una pieza blanca al otro lado
-                if (getBoardPiece(model, pos) == PIECE_WHITE) {
-                    
-                    // Cambiar de color las del medio
-                    for (int i = 1; i < x; i++) {
-                        Square intermedia = {move.x - i, move.y};
-                        setBoardPiece(model, intermedia, PIECE_WHITE); // Cambia las piezas negras a blancas
-                    }
-                    break;  // Termina el ciclo
-                    
-                }
-
-            } else {
-                // Si la casilla no es válida, termina
-                break;
-            }
-
-        } else { // Caso de que el jugador actual sea negro
-            if (isSquareValid(pos)) {
-                // Si encuentra una casilla vacía, termina el ciclo
-                if (getBoardPiece(model, pos) == PIECE_EMPTY)
-                    break;
-
-                if (getBoardPiece(model, pos) == PIECE_WHITE)
-                    continue;
-
-                // Si encuentra una pieza negra, verifica si ya había una pieza blanca al otro lado
-                if (getBoardPiece(model, pos) == PIECE_BLACK) {
-                    
-                    // Cambiar de color las del medio
-                    for (int i = 1; i < x; i++) {
-                        Square intermedia = {move.x - i, move.y};
-                        setBoardPiece(model, intermedia, PIECE_BLACK); // Cambia las piezas negras a blancas
-                    }
-                    break;  // Termina el ciclo
-                    
-                }
-
-            } else {
-                // Si la casilla no es válida, termina
-                break;
-            }
-        }
-    }
-    // arriba
-    for (int y = 1; y < BOARD_SIZE && terminar == 0; y++) {
-        Square pos = {move.x, move.y + y};
-
-        if (getCurrentPlayer(model) == PLAYER_WHITE) {
-
-            if (isSquareValid(pos)) {
-                // Si encuentra una casilla vacía, termina el ciclo
-                if (getBoardPiece(model, pos) == PIECE_EMPTY)
-                    break;
-
-                if (getBoardPiece(model, pos) == PIECE_BLACK)
-                    continue;
-
-                // Si encuentra una pieza negra, verifica si ya había una pieza blanca al otro lado
-                if (getBoardPiece(model, pos) == PIECE_WHITE) {
-                    
-                    // Cambiar de color las del medio
-                    for (int i = 1; i < y; i++) {
-                        Square intermedia = {move.x, move.y + i};
-                        setBoardPiece(model, intermedia, PIECE_WHITE); // Cambia las piezas negras a blancas
-                    }
-                    break;  // Termina el ciclo
-                    
-                }
-
-            } else {
-                // Si la casilla no es válida, termina
-                break;
-            }
-
-        } else { // Caso de que el jugador actual sea negro
-            if (isSquareValid(pos)) {
-                // Si encuentra una casilla vacía, termina el ciclo
-                if (getBoardPiece(model, pos) == PIECE_EMPTY)
-                    break;
-
-                if (getBoardPiece(model, pos) == PIECE_WHITE)
-                    continue;
-
-                // Si encuentra una pieza negra, verifica si ya había una pieza blanca al otro lado
-                if (getBoardPiece(model, pos) == PIECE_BLACK) {
-                    
-                    // Cambiar de color las del medio
-                    for (int i = 1; i < y; i++) {
-                        Square intermedia = {move.x, i+ move.y};
-                        setBoardPiece(model, intermedia, PIECE_BLACK); // Cambia las piezas negras a blancas
-                    }
-                    break;  // Termina el ciclo
-                    
-                }
-
-            } else {
-                // Si la casilla no es válida, termina
-                break;
-            }
-        }
-    }
-    // abajo
-    for (int y = 1; y < BOARD_SIZE && terminar == 0; y++) {
-        Square pos = {move.x, move.y - y};
-
-        if (getCurrentPlayer(model) == PLAYER_WHITE) {
-
-            if (isSquareValid(pos)) {
-                // Si encuentra una casilla vacía, termina el ciclo
-                if (getBoardPiece(model, pos) == PIECE_EMPTY)
-                    break;
-
-                if (getBoardPiece(model, pos) == PIECE_BLACK)
-                    continue;
-
-                // Si encuentra una pieza negra, verifica si ya había una pieza blanca al otro lado
-                if (getBoardPiece(model, pos) == PIECE_WHITE) {
-                    
-                    // Cambiar de color las del medio
-                    for (int i = 1; i < y; i++) {
-                        Square intermedia = {move.x, move.y - i};
-                        setBoardPiece(model, intermedia, PIECE_WHITE); // Cambia las piezas negras a blancas
-                    }
-                    break;  // Termina el ciclo
-                    
-                }
-
-            } else {
-                // Si la casilla no es válida, termina
-                break;
-            }
-
-        } else { // Caso de que el jugador actual sea negro
-            if (isSquareValid(pos)) {
-                // Si encuentra una casilla vacía, termina el ciclo
-                if (getBoardPiece(model, pos) == PIECE_EMPTY)
-                    break;
-
-                if (getBoardPiece(model, pos) == PIECE_WHITE)
-                    continue;
-
-                // Si encuentra una pieza negra, verifica si ya había una pieza blanca al otro lado
-                if (getBoardPiece(model, pos) == PIECE_BLACK) {
-                    
-                    // Cambiar de color las del medio
-                    for (int i = 1; i < y; i++) {
-                        Square intermedia = {move.x, move.y - i};
-                        setBoardPiece(model, intermedia, PIECE_BLACK); // Cambia las piezas negras a blancas
-                    }
-                    break;  // Termina el ciclo
-                    
-                }
-
-            } else {
-                // Si la casilla no es válida, termina
-                break;
-            }
-        }
-    }
-
-    for (int y = 1; y < BOARD_SIZE && terminar == 0; y++) {
-        Square pos = {move.x + y, move.y + y};
-
-        if (getCurrentPlayer(model) == PLAYER_WHITE) {
-
-            if (isSquareValid(pos)) {
-                // Si encuentra una casilla vacía, termina el ciclo
-                if (getBoardPiece(model, pos) == PIECE_EMPTY)
-                    break;
-
-                if (getBoardPiece(model, pos) == PIECE_BLACK)
-                    continue;
-
-                // Si encuentra una pieza negra, verifica si ya había una pieza blanca al otro lado
-                if (getBoardPiece(model, pos) == PIECE_WHITE) {
-                    
-                    // Cambiar de color las del medio
-                    for (int i = 1; i < y; i++) {
-                        Square intermedia = {move.x + i, move.y + i};
-                        setBoardPiece(model, intermedia, PIECE_WHITE); // Cambia las piezas negras a blancas
-                    }
-                    break;  // Termina el ciclo
-                    
-                }
-
-            } else {
-                // Si la casilla no es válida, termina
-                break;
-            }
-
-        } else { // Caso de que el jugador actual sea negro
-            if (isSquareValid(pos)) {
-                // Si encuentra una casilla vacía, termina el ciclo
-                if (getBoardPiece(model, pos) == PIECE_EMPTY)
-                    break;
-
-                if (getBoardPiece(model, pos) == PIECE_WHITE)
-                    continue;
-
-                // Si encuentra una pieza negra, verifica si ya había una pieza blanca al otro lado
-                if (getBoardPiece(model, pos) == PIECE_BLACK) {
-                    
-                    // Cambiar de color las del medio
-                    for (int i = 1; i < y; i++) {
-                        Square intermedia = {move.x + i, move.y + i};
-                        setBoardPiece(model, intermedia, PIECE_BLACK); // Cambia las piezas negras a blancas
-                    }
-                    break;  // Termina el ciclo
-                    
-                }
-
-            } else {
-                // Si la casilla no es válida, termina
-                break;
-            }
-        }
-    }
-
-    for (int y = 1; y < BOARD_SIZE && terminar == 0; y++) {
-        Square pos = {move.x - y, move.y - y};
-
-        if (getCurrentPlayer(model) == PLAYER_WHITE) {
-
-            if (isSquareValid(pos)) {
-                // Si encuentra una casilla vacía, termina el ciclo
-                if (getBoardPiece(model, pos) == PIECE_EMPTY)
-                    break;
-
-                if (getBoardPiece(model, pos) == PIECE_BLACK)
-                    continue;
-
-                // Si encuentra una pieza negra, verifica si ya había una pieza blanca al otro lado
-                if (getBoardPiece(model, pos) == PIECE_WHITE) {
-                    
-                    // Cambiar de color las del medio
-                    for (int i = 1; i < y; i++) {
-                        Square intermedia = {move.x - i, move.y - i};
-                        setBoardPiece(model, intermedia, PIECE_WHITE); // Cambia las piezas negras a blancas
-                    }
-                    break;  // Termina el ciclo
-                    
-                }
-
-            } else {
-                // Si la casilla no es válida, termina
-                break;
-            }
-
-        } else { // Caso de que el jugador actual sea negro
-            if (isSquareValid(pos)) {
-                // Si encuentra una casilla vacía, termina el ciclo
-                if (getBoardPiece(model, pos) == PIECE_EMPTY)
-                    break;
-
-                if (getBoardPiece(model, pos) == PIECE_WHITE)
-                    continue;
-
-                // Si encuentra una pieza negra, verifica si ya había una pieza blanca al otro lado
-                if (getBoardPiece(model, pos) == PIECE_BLACK) {
-                    
-                    // Cambiar de color las del medio
-                    for (int i = 1; i < y; i++) {
-                        Square intermedia = {move.x - i, move.y - i};
-                        setBoardPiece(model, intermedia, PIECE_BLACK); // Cambia las piezas negras a blancas
-                    }
-                    break;  // Termina el ciclo
-                    
-                }
-
-            } else {
-                // Si la casilla no es válida, termina
-                break;
-            }
-        }
-    }
+    Player player = getCurrentPlayer(model);
+    Player opponent = getOpponent(player);
 
-    for (int y = 1; y < BOARD_SIZE && terminar == 0; y++) {
-        Square pos = {move.x + y, move.y - y};
-
-        if (getCurrentPlayer(model) == PLAYER_WHITE) {
-
-            if (isSquareValid(pos)) {
-                // Si encuentra una casilla vacía, termina el ciclo
-                if (getBoardPiece(model, pos) == PIECE_EMPTY)
-                    break;
-
-                if (getBoardPiece(model, pos) == PIECE_BLACK)
-                    continue;
-
-                // Si encuentra una pieza negra, verifica si ya había una pieza blanca al otro lado
-                if (getBoardPiece(model, pos) == PIECE_WHITE) {
-                    
-                    // Cambiar de color las del medio
-                    for (int i = 1; i < y; i++) {
-                        Square intermedia = {move.x + i, move.y - i};
-                        setBoardPiece(model, intermedia, PIECE_WHITE); // Cambia las piezas negras a blancas
-                    }
-                    break;  // Termina el ciclo
-                    
-                }
-
-            } else {
-                // Si la casilla no es válida, termina
-                break;
-            }
-
-        } else { // Caso de que el jugador actual sea negro
-            if (isSquareValid(pos)) {
-                // Si encuentra una casilla vacía, termina el ciclo
-                if (getBoardPiece(model, pos) == PIECE_EMPTY)
-                    break;
-
-                if (getBoardPiece(model, pos) == PIECE_WHITE)
-                    continue;
-
-                // Si encuentra una pieza negra, verifica si ya había una pieza blanca al otro lado
-                if (getBoardPiece(model, pos) == PIECE_BLACK) {
-                    
-                    // Cambiar de color las del medio
-                    for (int i = 1; i < y; i++) {
-                        Square intermedia = {move.x + i, move.y - i};
-                        setBoardPiece(model, intermedia, PIECE_BLACK); // Cambia las piezas negras a blancas
-                    }
-                    break;  // Termina el ciclo
-                    
-                }
-
-            } else {
-                // Si la casilla no es válida, termina
-                break;
-            }
-        }
-    }
+    // Set game piece and flip the enclosed discs
+    Position position = getPosition(model);
+    makeMove(position, getSquareIndex(move));
 
-    for (int y = 1; y < BOARD_SIZE && terminar == 0; y++) {
-        Square pos = {move.x - y, move.y + y};
-
-        if (getCurrentPlayer(model) == PLAYER_WHITE) {
-
-            if (isSquareValid(pos)) {
-                // Si encuentra una casilla vacía, termina el ciclo
-                if (getBoardPiece(model, pos) == PIECE_EMPTY)
-                    break;
-
-                if (getBoardPiece(model, pos) == PIECE_BLACK)
-                    continue;
-
-                // Si encuentra una pieza negra, verifica si ya había una pieza blanca al otro lado
-                if (getBoardPiece(model, pos) == PIECE_WHITE) {
-                    
-                    // Cambiar de color las del medio
-                    for (int i = 1; i < y; i++) {
-                        Square intermedia = {move.x - i, move.y + i};
-                        setBoardPiece(model, intermedia, PIECE_WHITE); // Cambia las piezas negras a blancas
-                    }
-                    break;  // Termina el ciclo
-                    
-                }
-
-            } else {
-                // Si la casilla no es válida, termina
-                break;
-            }
-
-        } else { // Caso de que el jugador actual sea negro
-            if (isSquareValid(pos)) {
-                // Si encuentra una casilla vacía, termina el ciclo
-                if (getBoardPiece(model, pos) == PIECE_EMPTY)
-                    break;
-
-                if (getBoardPiece(model, pos) == PIECE_WHITE)
-                    continue;
-
-                // Si encuentra una pieza negra, verifica si ya había una pieza blanca al otro lado
-                if (getBoardPiece(model, pos) == PIECE_BLACK) {
-                    
-                    // Cambiar de color las del medio
-                    for (int i = 1; i < y; i++) {
-                        Square intermedia = {move.x - i, move.y + i};
-                        setBoardPiece(model, intermedia, PIECE_BLACK); // Cambia las piezas negras a blancas
-                    }
-                    break;  // Termina el ciclo
-                    
-                }
-
-            } else {
-                // Si la casilla no es válida, termina
-                break;
-            }
-        }
-    }
+    model.discs[player] = position.opponent;
+    model.discs[opponent] = position.player;
 
     // Update timer
-    double currentTime = GetTime();
+    double currentTime = getClockTime();
     model.playerTime[model.currentPlayer] += currentTime - model.turnTimer;
     model.turnTimer = currentTime;
 
     // Swap player
-    model.currentPlayer =
-        (model.currentPlayer == PLAYER_WHITE)
-            ? PLAYER_BLACK
-            : PLAYER_WHITE;
+    model.currentPlayer = opponent;
 
     // Game over?
-    Moves validMoves;
-    getValidMoves(model, validMoves);
-
-    if (validMoves.size() == 0)
+    if (!getMobility(position.player, position.opponent))
     {
         // Swap player
-        model.currentPlayer =
-            (model.currentPlayer == PLAYER_WHITE)
-                ? PLAYER_BLACK
-                : PLAYER_WHITE;
-
-        Moves validMoves;
-        getValidMoves(model, validMoves);
+        model.currentPlayer = player;
 
-        if (validMoves.size() == 0)
+        if (!getMobility(position.opponent, position.player))
             model.gameOver = true;
     }
 
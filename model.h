@@ -10,7 +10,8 @@
 
 #include <cstdint>
 #include <cstring>
-#include <vector>
+
+#include "bitboard.h"
 
 #define BOARD_SIZE 8
 
@@ -20,6 +21,17 @@ enum Player
     PLAYER_WHITE,
 };
 
+/**
+ * @brief Returns the other player. Usable as a template argument.
+ *
+ * @param player The player.
+ * @return The other player.
+ */
+constexpr Player getOpponent(Player player)
+{
+    return (player == PLAYER_WHITE) ? PLAYER_BLACK : PLAYER_WHITE;
+}
+
 enum Piece
 {
     PIECE_EMPTY,
@@ -47,12 +59,53 @@ struct GameModel
     double playerTime[2];
     double turnTimer;
 
-    Piece board[BOARD_SIZE][BOARD_SIZE];
+    Bitboard discs[2];
 
     Player humanPlayer;
 };
 
-typedef std::vector<Square> Moves;
+// Más que las casillas vacías que puede llegar a haber
+#define MAX_MOVES 64
+
+/**
+ * @brief A fixed-capacity list of moves, with a score slot per move.
+ */
+struct Moves
+{
+    int count = 0;
+    Square moves[MAX_MOVES];
+    int scores[MAX_MOVES];
+
+    int size() const
+    {
+        return count;
+    }
+
+    bool empty() const
+    {
+        return !count;
+    }
+
+    void push_back(Square move)
+    {
+        moves[count++] = move;
+    }
+
+    Square &operator[](int index)
+    {
+        return moves[index];
+    }
+
+    Square *begin()
+    {
+        return moves;
+    }
+
+    Square *end()
+    {
+        return moves + count;
+    }
+};
 
 /**
  * @brief Initializes a game model.
@@ -68,6 +121,13 @@ void initModel(GameModel &model);
  */
 void startModel(GameModel &model);
 
+/**
+ * @brief Returns a monotonic clock, used for the game timers.
+ *
+ * @return The time in seconds.
+ */
+double getClockTime();
+
 /**
  * @brief Returns the model's current player.
  *
@@ -112,6 +172,30 @@ Piece getBoardPiece(GameModel &model, Square square);
  */
 void setBoardPiece(GameModel &model, Square square, Piece piece);
 
+/**
+ * @brief Returns the model's position seen from the current player.
+ *
+ * @param model The game model.
+ * @return The position.
+ */
+Position getPosition(GameModel &model);
+
+/**
+ * @brief Returns the bitboard index of a square.
+ *
+ * @param square The square.
+ * @return The index (0 to 63).
+ */
+int getSquareIndex(Square square);
+
+/**
+ * @brief Returns the square at a bitboard index.
+ *
+ * @param index The index (0 to 63).
+ * @return The square.
+ */
+Square getIndexSquare(int index);
+
 /**
  * @brief Checks whether a square is within the board.
  *
@@ -128,6 +212,14 @@ bool isSquareValid(Square square);
  */
 void getValidMoves(GameModel &model, Moves &validMoves);
 
+/**
+ * @brief Appends the squares of a bitboard to a list of moves.
+ *
+ * @param moves The squares, in row order.
+ * @param validMoves A list that receives the moves.
+ */
+void getBitboardMoves(Bitboard moves, Moves &validMoves);
+
 /**
  * @brief Plays a move.
  *
@@ -0,0 +1,125 @@
+/**
+ * @brief Implements move ordering for the AI's search
+ *
+ * @copyright Copyright (c) 2023-2024
+ */
+
+#include <cstring>
+
+#include "ordering.h"
+
+#define ORDER_TT_MOVE (1 << 30)
+#define ORDER_KILLER (1 << 29)
+
+// Hasta esta profundidad se ordena por movilidad del rival
+#define MOBILITY_ORDERING_DEPTH 2
+// Peso de la prioridad fija de cada casilla frente a la historia
+#define PRIORITY_WEIGHT 16
+// Al llegar a este valor la historia se reduce a la mitad
+#define HISTORY_LIMIT (1 << 24)
+
+#define CORNERS 0x8100000000000081ULL
+
+/**
+ * @brief Static square priorities: corners first, X and C squares last.
+ */
+static const int squarePriorities[BOARD_SIZE * BOARD_SIZE] = {
+    9, 2, 8, 6, 6, 8, 2, 9,
+    2, 0, 4, 5, 5, 4, 0, 2,
+    8, 4, 7, 5, 5, 7, 4, 8,
+    6, 5, 5, 0, 0, 5, 5, 6,
+    6, 5, 5, 0, 0, 5, 5, 6,
+    8, 4, 7, 5, 5, 7, 4, 8,
+    2, 0, 4, 5, 5, 4, 0, 2,
+    9, 2, 8, 6, 6, 8, 2, 9,
+};
+
+void initMoveOrdering(MoveOrdering &ordering)
+{
+    memset(ordering.killers, -1, sizeof(ordering.killers));
+    memset(ordering.history, 0, sizeof(ordering.history));
+}
+
+void scoreMoves(MoveOrdering &ordering,
+                Position &position,
+                Player player,
+                Moves &validMoves,
+                int ttMove,
+                int depth)
+{
+    int emptyCount = BOARD_SIZE * BOARD_SIZE - countBits(position.player | position.opponent);
+    int *killers = ordering.killers[emptyCount];
+    int *history = ordering.history[player];
+
+    for (int i = 0; i < validMoves.size(); i++)
+    {
+        int square = getSquareIndex(validMoves[i]);
+        int score;
+
+        if (square == ttMove)
+            score = ORDER_TT_MOVE;
+        else if (square == killers[0])
+            score = ORDER_KILLER;
+        else if (square == killers[1])
+            score = ORDER_KILLER - 1;
+        else if (depth <= MOBILITY_ORDERING_DEPTH)
+        {
+            // Primero las jugadas que le dejan menos opciones al rival
+            Position next = position;
+            makeMove(next, square);
+            Bitboard replies = getMobility(next.player, next.opponent);
+            int mobility = countBits(replies) + countBits(replies & CORNERS);
+
+            score = ((BOARD_SIZE * BOARD_SIZE - mobility) << 4) + squarePriorities[square];
+        }
+        else
+            score = history[square] + PRIORITY_WEIGHT * squarePriorities[square];
+
+        validMoves.scores[i] = score;
+    }
+}
+
+void sortMoves(Moves &validMoves)
+{
+    // Inserción: las listas son cortas y suelen estar casi ordenadas
+    for (int i = 1; i < validMoves.size(); i++)
+    {
+        Square move = validMoves.moves[i];
+        int score = validMoves.scores[i];
+
+        int j = i - 1;
+        for (; (j >= 0) && (validMoves.scores[j] < score); j--)
+        {
+            validMoves.moves[j + 1] = validMoves.moves[j];
+            validMoves.scores[j + 1] = validMoves.scores[j];
+        }
+
+        validMoves.moves[j + 1] = move;
+        validMoves.scores[j + 1] = score;
+    }
+}
+
+void updateMoveOrdering(MoveOrdering &ordering,
+                        Position &position,
+                        Player player,
+                        int square,
+                        int depth)
+{
+    int emptyCount = BOARD_SIZE * BOARD_SIZE - countBits(position.player | position.opponent);
+    int *killers = ordering.killers[emptyCount];
+
+    if (killers[0] != square)
+    {
+        killers[1] = killers[0];
+        killers[0] = square;
+    }
+
+    int *history = ordering.history[player];
+    history[square] += depth * depth;
+
+    if (history[square] >= HISTORY_LIMIT)
+    {
+        for (int i = 0; i < BOARD_SIZE * BOARD_SIZE; i++)
+            history[i] /= 2;
+    }
+}
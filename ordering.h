@@ -0,0 +1,76 @@
+/**
+ * @brief Implements move ordering for the AI's search
+ *
+ * @copyright Copyright (c) 2023-2024
+ */
+
+#ifndef ORDERING_H
+#define ORDERING_H
+
+#include "model.h"
+
+#define KILLER_COUNT 2
+
+/**
+ * @brief Killer moves and history counters of a search.
+ *
+ * Killers are kept per number of empty squares, which identifies the
+ * ply below the root even across passes.
+ */
+struct MoveOrdering
+{
+    int killers[BOARD_SIZE * BOARD_SIZE + 1][KILLER_COUNT];
+    int history[2][BOARD_SIZE * BOARD_SIZE];
+};
+
+/**
+ * @brief Clears the killer moves and history counters.
+ *
+ * @param ordering The move ordering tables.
+ */
+void initMoveOrdering(MoveOrdering &ordering);
+
+/**
+ * @brief Scores a node's moves into the move list's score slots.
+ *
+ * The table move comes first, then the killers. The other moves are
+ * ordered by history and static square priorities (corners first) or,
+ * close to the leaves, by the opponent's resulting mobility.
+ *
+ * @param ordering The move ordering tables.
+ * @param position The position.
+ * @param player The colour of the side to move.
+ * @param validMoves The move list.
+ * @param ttMove The transposition table move, or -1.
+ * @param depth The remaining search depth.
+ */
+void scoreMoves(MoveOrdering &ordering,
+                Position &position,
+                Player player,
+                Moves &validMoves,
+                int ttMove,
+                int depth);
+
+/**
+ * @brief Sorts a move list by decreasing score.
+ *
+ * @param validMoves The move list.
+ */
+void sortMoves(Moves &validMoves);
+
+/**
+ * @brief Records a move that caused a beta cutoff.
+ *
+ * @param ordering The move ordering tables.
+ * @param position The position where the move was played.
+ * @param player The colour of the side to move.
+ * @param square The square index of the move.
+ * @param depth The remaining search depth.
+ */
+void updateMoveOrdering(MoveOrdering &ordering,
+                        Position &position,
+                        Player player,
+                        int square,
+                        int depth);
+
+#endif
@@ -0,0 +1,292 @@
+/**
+ * @brief Implements the AI's pattern evaluation
+ *
+ * @copyright Copyright (c) 2023-2024
+ */
+
+#include <cstdio>
+#include <cstring>
+
+#include "mappedfile.h"
+#include "pattern.h"
+
+#define PATTERN_MAGIC "EDAVPAT"
+#define PATTERN_VERSION 1
+
+// Casillas del patrón más grande
+#define PATTERN_MAX_SIZE 10
+// Instancias que pueden pasar por una misma casilla
+#define SQUARE_MAX_INSTANCES 8
+
+/**
+ * @brief The header of a weights file, followed by the weights of every
+ * phase as int16_t in the machine's byte order.
+ */
+struct PatternWeightsHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t phaseCount;
+    uint32_t weightCount;
+    uint32_t scale;
+};
+
+/**
+ * @brief A pattern's squares, in one of its placements.
+ */
+struct PatternShape
+{
+    int size;
+    int symmetries; // 2: diagonal principal, 4: rotaciones, 8: y sus reflejos
+    int squares[PATTERN_MAX_SIZE][2];
+};
+
+static const PatternShape patternShapes[] = {
+    // Borde con las casillas X
+    {10, 4, {{0, 0}, {1, 0}, {2, 0}, {3, 0}, {4, 0}, {5, 0}, {6, 0}, {7, 0}, {1, 1}, {6, 1}}},
+    // Esquina de 3x3
+    {9, 4, {{0, 0}, {1, 0}, {2, 0}, {0, 1}, {1, 1}, {2, 1}, {0, 2}, {1, 2}, {2, 2}}},
+    // Esquina de 2x5
+    {10, 8, {{0, 0}, {1, 0}, {2, 0}, {3, 0}, {4, 0}, {0, 1}, {1, 1}, {2, 1}, {3, 1}, {4, 1}}},
+    // Diagonales
+    {8, 2, {{0, 0}, {1, 1}, {2, 2}, {3, 3}, {4, 4}, {5, 5}, {6, 6}, {7, 7}}},
+    {7, 4, {{1, 0}, {2, 1}, {3, 2}, {4, 3}, {5, 4}, {6, 5}, {7, 6}}},
+    {6, 4, {{2, 0}, {3, 1}, {4, 2}, {5, 3}, {6, 4}, {7, 5}}},
+    {5, 4, {{3, 0}, {4, 1}, {5, 2}, {6, 3}, {7, 4}}},
+    {4, 4, {{4, 0}, {5, 1}, {6, 2}, {7, 3}}},
+};
+
+/**
+ * @brief The pattern instances and, for every square, the instances
+ * that contain it with the square's power of 3.
+ */
+static struct PatternTables
+{
+    int offsets[PATTERN_INSTANCE_COUNT];
+    int sizes[PATTERN_INSTANCE_COUNT];
+    int squares[PATTERN_INSTANCE_COUNT][PATTERN_MAX_SIZE];
+
+    int squareCounts[BOARD_SIZE * BOARD_SIZE];
+    int squareInstances[BOARD_SIZE * BOARD_SIZE][SQUARE_MAX_INSTANCES];
+    int squarePowers[BOARD_SIZE * BOARD_SIZE][SQUARE_MAX_INSTANCES];
+
+    PatternTables()
+    {
+        memset(squareCounts, 0, sizeof(squareCounts));
+
+        int instance = 0;
+        int offset = 0;
+        for (const PatternShape &shape : patternShapes)
+        {
+            for (int symmetry = 0; symmetry < shape.symmetries; symmetry++)
+            {
+                offsets[instance] = offset;
+                sizes[instance] = shape.size;
+
+                int power = 1;
+                for (int i = 0; i < shape.size; i++)
+                {
+                    int x = shape.squares[i][0];
+                    int y = shape.squares[i][1];
+
+                    // Las simetrías 4 a 7 reflejan sobre la diagonal principal
+                    if (symmetry >= 4)
+                    {
+                        int t = x;
+                        x = y;
+                        y = t;
+                    }
+
+                    // Rotaciones de 90 grados
+                    for (int r = 0; r < (symmetry & 3); r++)
+                    {
+                        int t = x;
+                        x = BOARD_SIZE - 1 - y;
+                        y = t;
+                    }
+
+                    int square = y * BOARD_SIZE + x;
+                    squares[instance][i] = square;
+
+                    int &count = squareCounts[square];
+                    squareInstances[square][count] = instance;
+                    squarePowers[square][count] = power;
+                    count++;
+
+                    power *= 3;
+                }
+
+                instance++;
+            }
+
+            int tableSize = 1;
+            for (int i = 0; i < shape.size; i++)
+                tableSize *= 3;
+            offset += tableSize;
+        }
+    }
+} patternTables;
+
+static MappedFile patternFile;
+static const int16_t *patternWeights;
+
+void initPatternIndices(Position &position, Player player, PatternIndices &patterns)
+{
+    Bitboard black = (player == PLAYER_BLACK) ? position.player : position.opponent;
+    Bitboard white = (player == PLAYER_BLACK) ? position.opponent : position.player;
+
+    for (int i = 0; i < PATTERN_INSTANCE_COUNT; i++)
+    {
+        int index = 0;
+        for (int j = patternTables.sizes[i] - 1; j >= 0; j--)
+        {
+            Bitboard bit = 1ULL << patternTables.squares[i][j];
+            index = 3 * index + ((black & bit) ? 1 : ((white & bit) ? 2 : 0));
+        }
+
+        patterns.indices[i] = (uint16_t)index;
+    }
+}
+
+/**
+ * @brief Applies a move to the pattern indices, or takes it back.
+ *
+ * @tparam P The colour of the side that moved.
+ * @tparam SIGN 1 to play the move, -1 to take it back.
+ * @param patterns The indices.
+ * @param square The square index of the move.
+ * @param flips The discs the move flipped.
+ */
+template <Player P, int SIGN>
+static inline void updatePatternIndices(PatternIndices &patterns, int square, Bitboard flips)
+{
+    // Negras valen 1 y blancas 2: dar vuelta una ficha suma o resta una vez su potencia
+    const int placed = (P == PLAYER_BLACK) ? SIGN : 2 * SIGN;
+    const int flipped = (P == PLAYER_BLACK) ? -SIGN : SIGN;
+
+    for (int i = 0; i < patternTables.squareCounts[square]; i++)
+        patterns.indices[patternTables.squareInstances[square][i]] +=
+            (uint16_t)(placed * patternTables.squarePowers[square][i]);
+
+    for (; flips; flips &= flips - 1)
+    {
+        int flip = getFirstBit(flips);
+        for (int i = 0; i < patternTables.squareCounts[flip]; i++)
+            patterns.indices[patternTables.squareInstances[flip][i]] +=
+                (uint16_t)(flipped * patternTables.squarePowers[flip][i]);
+    }
+}
+
+template <Player P>
+void playPatternMove(PatternIndices &patterns, int square, Bitboard flips)
+{
+    updatePatternIndices<P, 1>(patterns, square, flips);
+}
+
+template <Player P>
+void undoPatternMove(PatternIndices &patterns, int square, Bitboard flips)
+{
+    updatePatternIndices<P, -1>(patterns, square, flips);
+}
+
+template void playPatternMove<PLAYER_BLACK>(PatternIndices &, int, Bitboard);
+template void playPatternMove<PLAYER_WHITE>(PatternIndices &, int, Bitboard);
+template void undoPatternMove<PLAYER_BLACK>(PatternIndices &, int, Bitboard);
+template void undoPatternMove<PLAYER_WHITE>(PatternIndices &, int, Bitboard);
+
+int getPatternPhase(int emptyCount)
+{
+    // Las fichas van de 4 a 64
+    int discCount = BOARD_SIZE * BOARD_SIZE - emptyCount;
+
+    return (discCount - 4) * PATTERN_PHASE_COUNT / (BOARD_SIZE * BOARD_SIZE - 3);
+}
+
+void getPatternFeatures(PatternIndices &patterns, uint32_t features[PATTERN_INSTANCE_COUNT])
+{
+    for (int i = 0; i < PATTERN_INSTANCE_COUNT; i++)
+        features[i] = patternTables.offsets[i] + patterns.indices[i];
+}
+
+bool loadPatternWeights(const char *path)
+{
+    freePatternWeights();
+
+    if (!mapFile(path, patternFile))
+        return false;
+
+    const PatternWeightsHeader *header = (const PatternWeightsHeader *)patternFile.data;
+    size_t expectedSize = sizeof(PatternWeightsHeader) +
+                          sizeof(int16_t) * PATTERN_PHASE_COUNT * PATTERN_WEIGHT_COUNT;
+    if ((patternFile.size != expectedSize) ||
+        memcmp(header->magic, PATTERN_MAGIC, sizeof(header->magic)) ||
+        (header->version != PATTERN_VERSION) ||
+        (header->phaseCount != PATTERN_PHASE_COUNT) ||
+        (header->weightCount != PATTERN_WEIGHT_COUNT) ||
+        (header->scale != PATTERN_WEIGHT_SCALE))
+    {
+        fprintf(stderr, "%s: not a version %d pattern weights file\n", path, PATTERN_VERSION);
+        unmapFile(patternFile);
+
+        return false;
+    }
+
+    patternWeights = (const int16_t *)(header + 1);
+
+    return true;
+}
+
+void freePatternWeights()
+{
+    unmapFile(patternFile);
+    patternWeights = nullptr;
+}
+
+bool hasPatternWeights()
+{
+    return patternWeights != nullptr;
+}
+
+bool savePatternWeights(const char *path, const int16_t *weights)
+{
+    FILE *file = fopen(path, "wb");
+    if (!file)
+        return false;
+
+    PatternWeightsHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, PATTERN_MAGIC, sizeof(header.magic));
+    header.version = PATTERN_VERSION;
+    header.phaseCount = PATTERN_PHASE_COUNT;
+    header.weightCount = PATTERN_WEIGHT_COUNT;
+    header.scale = PATTERN_WEIGHT_SCALE;
+
+    size_t weightCount = (size_t)PATTERN_PHASE_COUNT * PATTERN_WEIGHT_COUNT;
+    bool written = (fwrite(&header, sizeof(header), 1, file) == 1) &&
+                   (fwrite(weights, sizeof(int16_t), weightCount, file) == weightCount);
+
+    return (fclose(file) == 0) && written;
+}
+
+template <Player P>
+int evaluatePatterns(PatternIndices &patterns, int emptyCount)
+{
+    const int16_t *weights = patternWeights + getPatternPhase(emptyCount) * PATTERN_WEIGHT_COUNT;
+
+    int score = 0;
+    for (int i = 0; i < PATTERN_INSTANCE_COUNT; i++)
+        score += weights[patternTables.offsets[i] + patterns.indices[i]];
+
+    // Los pesos valen para negras
+    if (P == PLAYER_WHITE)
+        score = -score;
+
+    // Redondeo a fichas enteras
+    if (score >= 0)
+        return (score + PATTERN_WEIGHT_SCALE / 2) / PATTERN_WEIGHT_SCALE;
+    else
+        return -((-score + PATTERN_WEIGHT_SCALE / 2) / PATTERN_WEIGHT_SCALE);
+}
+
+template int evaluatePatterns<PLAYER_BLACK>(PatternIndices &, int);
+template int evaluatePatterns<PLAYER_WHITE>(PatternIndices &, int);
@@ -0,0 +1,123 @@
+/**
+ * @brief Implements the AI's pattern evaluation
+ *
+ * @copyright Copyright (c) 2023-2024
+ */
+
+#ifndef PATTERN_H
+#define PATTERN_H
+
+#include <cstdint>
+
+#include "model.h"
+
+// Instancias de patrones en el tablero: 4 bordes con 2X, 4 esquinas de 3x3,
+// 8 regiones de 2x5, 2 diagonales de 8 y 4 de cada una de 7, 6, 5 y 4
+#define PATTERN_INSTANCE_COUNT 34
+
+// Pesos por fase y por tabla de patrón
+#define PATTERN_PHASE_COUNT 12
+#define PATTERN_WEIGHT_COUNT 147582
+
+// Los pesos están en fracciones de ficha
+#define PATTERN_WEIGHT_SCALE 32
+
+/**
+ * @brief The base-3 index of every pattern instance of a position.
+ *
+ * Each square adds 0 (empty), 1 (black) or 2 (white) times its power
+ * of 3 in the instance.
+ */
+struct PatternIndices
+{
+    uint16_t indices[PATTERN_INSTANCE_COUNT];
+};
+
+/**
+ * @brief Computes the pattern indices of a position.
+ *
+ * @param position The position.
+ * @param player The colour of the side to move.
+ * @param patterns Receives the indices.
+ */
+void initPatternIndices(Position &position, Player player, PatternIndices &patterns);
+
+/**
+ * @brief Updates the pattern indices after a move.
+ *
+ * @tparam P The colour of the side that moved.
+ * @param patterns The indices.
+ * @param square The square index of the move.
+ * @param flips The discs the move flipped.
+ */
+template <Player P>
+void playPatternMove(PatternIndices &patterns, int square, Bitboard flips);
+
+/**
+ * @brief Takes back a move from the pattern indices.
+ *
+ * @tparam P The colour of the side that moved.
+ * @param patterns The indices.
+ * @param square The square index of the move.
+ * @param flips The discs the move flipped.
+ */
+template <Player P>
+void undoPatternMove(PatternIndices &patterns, int square, Bitboard flips);
+
+/**
+ * @brief Returns the weight phase of a position.
+ *
+ * @param emptyCount The number of empty squares.
+ * @return The phase.
+ */
+int getPatternPhase(int emptyCount);
+
+/**
+ * @brief Returns the weight of each pattern instance within a phase's weights.
+ *
+ * @param patterns The indices.
+ * @param features Receives the offsets of the weights.
+ */
+void getPatternFeatures(PatternIndices &patterns, uint32_t features[PATTERN_INSTANCE_COUNT]);
+
+/**
+ * @brief Memory-maps a weights file.
+ *
+ * @param path The path of the file.
+ * @return The file was mapped and has the expected format.
+ */
+bool loadPatternWeights(const char *path);
+
+/**
+ * @brief Unmaps the weights file.
+ */
+void freePatternWeights();
+
+/**
+ * @brief Checks whether a weights file is loaded.
+ *
+ * @return true or false.
+ */
+bool hasPatternWeights();
+
+/**
+ * @brief Writes a weights file.
+ *
+ * @param path The path of the file.
+ * @param weights The weights, PATTERN_WEIGHT_COUNT for each phase.
+ * @return The file was written.
+ */
+bool savePatternWeights(const char *path, const int16_t *weights);
+
+/**
+ * @brief Evaluates a position with the pattern weights.
+ *
+ * @tparam P The colour of the side to move.
+ * @param patterns The position's indices.
+ * @param emptyCount The number of empty squares.
+ * @return The evaluation, in discs, from the side to move's point of view.
+ */
+template <Player P>
+int evaluatePatterns(PatternIndices &patterns, int emptyCount);
+
+#endif
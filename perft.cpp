@@ -0,0 +1,436 @@
+/**
+ * @brief Counts move-generation leaf nodes and checks the known counts
+ *
+ * Usage: edaversi_perft [options] [depth]
+ *
+ *   -threads N        Splits the positions a few plies from the root
+ *                     among N threads (default 1).
+ *   -hash             Reuses the counts of transposed and symmetric
+ *                     positions (one table per thread).
+ *   -model            Counts through getValidMoves and playMove on a
+ *                     GameModel instead of the bitboard functions.
+ *   -kernel NAME      Plays moves with the scalar or avx2 flip kernel
+ *                     (default: the fastest one the CPU supports).
+ *   -kernels          Checks at every node that all the flip kernels
+ *                     give the same flips on every empty square.
+ *   -position "BOARD SIDE"
+ *                     Starts from a position given as 64 squares (X
+ *                     black, O white, - empty) and the side to move.
+ *
+ * Counts every depth from 1 to the given one (default 9). A pass is a
+ * move, and a finished game is a leaf at any depth. From the initial
+ * position, each count is checked against the known one. The exit
+ * status is 1 if any count differs or the kernels disagree.
+ *
+ * @copyright Copyright (c) 2023-2024
+ */
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "model.h"
+#include "symmetry.h"
+#include "threadpool.h"
+
+#define DEFAULT_DEPTH 9
+
+// Plies desde la raíz en los que se reparten las posiciones entre los hilos
+#define SPLIT_PLIES 3
+
+// 2^18 entradas de 24 bytes (6 MB) por hilo
+#define PERFT_HASH_BITS 18
+#define PERFT_HASH_SIZE (1 << PERFT_HASH_BITS)
+// Más cerca de las hojas, contar cuesta menos que buscar en la tabla
+#define PERFT_HASH_MIN_DEPTH 3
+
+/**
+ * @brief Known counts from the initial position, by depth.
+ */
+static const uint64_t knownCounts[] = {
+    1,
+    4,
+    12,
+    56,
+    244,
+    1396,
+    8200,
+    55092,
+    390216,
+    3005288,
+    24571284,
+    212258800,
+    1939886636,
+    18429641748,
+    184042084512,
+};
+
+/**
+ * @brief A stored count, with its position in canonical orientation.
+ */
+struct PerftEntry
+{
+    Bitboard player;
+    Bitboard opponent;
+    uint64_t depthCount; // Profundidad en los 8 bits altos, cuenta en el resto
+};
+
+/**
+ * @brief How to count.
+ */
+struct PerftOptions
+{
+    int threadCount;
+    bool hash;
+    bool model;
+    bool checkKernels;
+};
+
+// Con -kernels, posiciones en las que los kernels no coinciden
+static std::atomic<uint64_t> kernelMismatches(0);
+
+/**
+ * @brief Checks that all the flip kernels agree on a position.
+ *
+ * Compares the flips of every empty square, legal move or not.
+ *
+ * @param position The position.
+ */
+static void checkFlipKernels(Position &position)
+{
+    Bitboard empty = ~(position.player | position.opponent);
+
+    for (; empty; empty &= empty - 1)
+    {
+        int square = getFirstBit(empty);
+        Bitboard flips = getKernelFlips(FLIP_KERNEL_SCALAR, position.player, position.opponent, square);
+
+        for (FlipKernel kernel : {FLIP_KERNEL_AVX2})
+        {
+            if (hasFlipKernel(kernel) &&
+                (getKernelFlips(kernel, position.player, position.opponent, square) != flips))
+                kernelMismatches++;
+        }
+    }
+}
+
+/**
+ * @brief Counts the leaf nodes of a position with the bitboard functions.
+ *
+ * @param position The position.
+ * @param depth The depth, in moves.
+ * @param table The hash table, or nullptr.
+ * @param checkKernels Checks the flip kernels at every node.
+ * @return The number of leaf nodes.
+ */
+static uint64_t perft(Position &position, int depth, PerftEntry *table, bool checkKernels)
+{
+    if (checkKernels)
+        checkFlipKernels(position);
+
+    if (depth == 0)
+        return 1;
+
+    Bitboard moves = getMobility(position.player, position.opponent);
+
+    if (!moves)
+    {
+        // Partida terminada: es una hoja
+        if (!getMobility(position.opponent, position.player))
+            return 1;
+
+        passMove(position);
+        uint64_t count = perft(position, depth - 1, table, checkKernels);
+        passMove(position);
+
+        return count;
+    }
+
+    // En la última jugada basta con contarlas
+    if ((depth == 1) && !checkKernels)
+        return countBits(moves);
+
+    PerftEntry *entry = nullptr;
+    Position canonical;
+    if (table && (depth >= PERFT_HASH_MIN_DEPTH))
+    {
+        int symmetry;
+        canonical = getCanonicalPosition(position, symmetry);
+
+        uint64_t key = (canonical.player * 0x9e3779b97f4a7c15ULL) ^
+                       (canonical.opponent * 0xc2b2ae3d27d4eb4fULL);
+        entry = &table[(key ^ (key >> 32) ^ (uint64_t)depth) & (PERFT_HASH_SIZE - 1)];
+
+        if ((entry->player == canonical.player) &&
+            (entry->opponent == canonical.opponent) &&
+            ((int)(entry->depthCount >> 56) == depth))
+            return entry->depthCount & ((1ULL << 56) - 1);
+    }
+
+    uint64_t count = 0;
+    for (; moves; moves &= moves - 1)
+    {
+        int square = getFirstBit(moves);
+        Bitboard flips = makeMove(position, square);
+        count += perft(position, depth - 1, table, checkKernels);
+        undoMove(position, square, flips);
+    }
+
+    if (entry)
+    {
+        entry->player = canonical.player;
+        entry->opponent = canonical.opponent;
+        entry->depthCount = ((uint64_t)depth << 56) | count;
+    }
+
+    return count;
+}
+
+/**
+ * @brief Counts the leaf nodes of a position with the game model.
+ *
+ * @param model The game model.
+ * @param depth The depth, in moves.
+ * @return The number of leaf nodes.
+ */
+static uint64_t perftModel(GameModel &model, int depth)
+{
+    if ((depth == 0) || model.gameOver)
+        return 1;
+
+    Moves validMoves;
+    getValidMoves(model, validMoves);
+
+    uint64_t count = 0;
+    for (Square move : validMoves)
+    {
+        GameModel child = model;
+        playMove(child, move);
+
+        // playMove salta la pasada del rival, que también es una jugada
+        if (!child.gameOver && (child.currentPlayer == model.currentPlayer))
+            count += (depth == 1) ? 1 : perftModel(child, depth - 2);
+        else
+            count += perftModel(child, depth - 1);
+    }
+
+    return count;
+}
+
+/**
+ * @brief Collects the game models a number of plies from the root.
+ *
+ * Positions where the game is over before then are collected as they
+ * are, with fewer plies played.
+ *
+ * @param model The game model.
+ * @param plies The plies to play.
+ * @param models Receives the models and the plies played to reach them.
+ */
+static void splitPerft(GameModel &model, int plies, std::vector<std::pair<GameModel, int>> &models, int played = 0)
+{
+    if ((plies == 0) || model.gameOver)
+    {
+        models.push_back({model, played});
+        return;
+    }
+
+    Moves validMoves;
+    getValidMoves(model, validMoves);
+
+    for (Square move : validMoves)
+    {
+        GameModel child = model;
+        playMove(child, move);
+
+        // Una pasada del rival cuenta como otra jugada
+        if (!child.gameOver && (child.currentPlayer == model.currentPlayer))
+        {
+            if (plies == 1)
+            {
+                models.push_back({child, played + 2});
+                continue;
+            }
+
+            splitPerft(child, plies - 2, models, played + 2);
+        }
+        else
+            splitPerft(child, plies - 1, models, played + 1);
+    }
+}
+
+/**
+ * @brief Counts the leaf nodes of a position.
+ *
+ * @param model The game model.
+ * @param depth The depth, in moves.
+ * @param options How to count.
+ * @return The number of leaf nodes.
+ */
+static uint64_t countLeaves(GameModel &model, int depth, PerftOptions &options)
+{
+    // Cada hilo cuenta las posiciones que quedan, una por vez
+    std::vector<std::pair<GameModel, int>> models;
+    if ((options.threadCount > 1) && (depth > SPLIT_PLIES))
+        splitPerft(model, SPLIT_PLIES, models);
+    else
+        models.push_back({model, 0});
+
+    std::atomic<size_t> next(0);
+    std::atomic<uint64_t> total(0);
+    runThreadPool(options.threadCount, [&](int) {
+        std::vector<PerftEntry> table(options.hash ? PERFT_HASH_SIZE : 0);
+
+        for (size_t i = next++; i < models.size(); i = next++)
+        {
+            GameModel &leaf = models[i].first;
+            int leafDepth = depth - models[i].second;
+
+            uint64_t count;
+            if (options.model)
+                count = perftModel(leaf, leafDepth);
+            else if (leaf.gameOver)
+                count = 1;
+            else
+            {
+                Position position = getPosition(leaf);
+                count = perft(position,
+                              leafDepth,
+                              options.hash ? table.data() : nullptr,
+                              options.checkKernels);
+            }
+
+            total += count;
+        }
+    });
+
+    return total;
+}
+
+/**
+ * @brief Reads a position given as 64 squares and the side to move.
+ *
+ * @param text The position.
+ * @param model Receives the position.
+ * @return The text holds a position.
+ */
+static bool readPosition(const char *text, GameModel &model)
+{
+    if (strlen(text) < BOARD_SIZE * BOARD_SIZE + 2)
+        return false;
+
+    initModel(model);
+    model.gameOver = false;
+    model.turnTimer = getClockTime();
+
+    for (int i = 0; i < BOARD_SIZE * BOARD_SIZE; i++)
+    {
+        Square square = {i % BOARD_SIZE, i / BOARD_SIZE};
+
+        if ((text[i] == 'X') || (text[i] == 'x') || (text[i] == '*'))
+            setBoardPiece(model, square, PIECE_BLACK);
+        else if ((text[i] == 'O') || (text[i] == 'o'))
+            setBoardPiece(model, square, PIECE_WHITE);
+        else if ((text[i] != '-') && (text[i] != '.'))
+            return false;
+    }
+
+    char side = text[BOARD_SIZE * BOARD_SIZE + 1];
+    if ((side == 'X') || (side == 'x') || (side == '*'))
+        model.currentPlayer = PLAYER_BLACK;
+    else if ((side == 'O') || (side == 'o'))
+        model.currentPlayer = PLAYER_WHITE;
+    else
+        return false;
+
+    // Si ninguno puede jugar, la partida ya terminó
+    Position position = getPosition(model);
+    model.gameOver = !getMobility(position.player, position.opponent) &&
+                     !getMobility(position.opponent, position.player);
+
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    PerftOptions options = {1, false, false, false};
+    int maxDepth = DEFAULT_DEPTH;
+    bool initialPosition = true;
+
+    GameModel model;
+    initModel(model);
+    startModel(model);
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "-threads") && (i + 1 < argc))
+            options.threadCount = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-hash"))
+            options.hash = true;
+        else if (!strcmp(argv[i], "-model"))
+            options.model = true;
+        else if (!strcmp(argv[i], "-kernel") && (i + 1 < argc))
+        {
+            i++;
+            FlipKernel kernel = !strcmp(argv[i], "avx2") ? FLIP_KERNEL_AVX2 : FLIP_KERNEL_SCALAR;
+            if ((strcmp(argv[i], "scalar") && strcmp(argv[i], "avx2")) || !setFlipKernel(kernel))
+            {
+                fprintf(stderr, "Flip kernel not available: %s\n", argv[i]);
+                return 1;
+            }
+        }
+        else if (!strcmp(argv[i], "-kernels"))
+            options.checkKernels = true;
+        else if (!strcmp(argv[i], "-position") && (i + 1 < argc))
+        {
+            if (!readPosition(argv[++i], model))
+            {
+                fprintf(stderr, "Invalid position: %s\n", argv[i]);
+                return 1;
+            }
+            initialPosition = false;
+        }
+        else if (atoi(argv[i]) > 0)
+            maxDepth = atoi(argv[i]);
+        else
+        {
+            fprintf(stderr, "Invalid option: %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    printf("depth           leaves  time (s)  Mnodes/s\n");
+
+    int failures = 0;
+    for (int depth = 1; depth <= maxDepth; depth++)
+    {
+        double startTime = getClockTime();
+        uint64_t count = countLeaves(model, depth, options);
+        double time = getClockTime() - startTime;
+
+        bool known = initialPosition && (depth < (int)(sizeof(knownCounts) / sizeof(knownCounts[0])));
+        bool failed = known && (count != knownCounts[depth]);
+        failures += failed;
+
+        printf("%5d %16llu %9.3f %9.1f%s\n",
+               depth,
+               (unsigned long long)count,
+               time,
+               time ? count / time / 1e6 : 0.0,
+               failed ? "  FAILED" : (known ? "  ok" : ""));
+    }
+
+    if (options.checkKernels)
+    {
+        if (!hasFlipKernel(FLIP_KERNEL_AVX2))
+            printf("Only the scalar flip kernel is available\n");
+        else if (kernelMismatches)
+            printf("Flip kernels disagree on %llu squares\n", (unsigned long long)kernelMismatches);
+        else
+            printf("Flip kernels agree\n");
+    }
+
+    return (failures || kernelMismatches) ? 1 : 0;
+}
@@ -0,0 +1,130 @@
+/**
+ * @brief Measures how the AI's search scales with the number of threads
+ *
+ * Usage: edaversi_smp [-split] [depth [threads...]]
+ *
+ * Searches a fixed set of positions to a fixed depth with each thread
+ * count and reports time to depth, nodes per second, speedup over the
+ * first thread count and how many positions got the same move as with
+ * it. Threads share the search with Lazy SMP, or with -split by
+ * splitting the root moves.
+ *
+ * @copyright Copyright (c) 2023-2024
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "ai.h"
+#include "transposition.h"
+
+#define DEFAULT_DEPTH 10
+#define POSITION_COUNT 16
+// Jugadas al azar desde la posición inicial
+#define OPENING_MOVES 20
+
+/**
+ * @brief Plays random moves from the initial position.
+ *
+ * @param model The game model.
+ * @param seed The random generator state.
+ */
+static void playRandomOpening(GameModel &model, uint64_t &seed)
+{
+    initModel(model);
+    startModel(model);
+
+    for (int i = 0; (i < OPENING_MOVES) && !model.gameOver; i++)
+    {
+        Moves validMoves;
+        getValidMoves(model, validMoves);
+
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        playMove(model, validMoves[(int)((seed >> 33) % validMoves.size())]);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    ParallelSearch parallelSearch = PARALLEL_LAZY_SMP;
+    int firstArgument = 1;
+    if ((argc > 1) && !strcmp(argv[1], "-split"))
+    {
+        parallelSearch = PARALLEL_ROOT_SPLIT;
+        firstArgument++;
+    }
+
+    int depth = (argc > firstArgument) ? atoi(argv[firstArgument]) : DEFAULT_DEPTH;
+
+    std::vector<int> threadCounts;
+    for (int i = firstArgument + 1; i < argc; i++)
+        threadCounts.push_back(atoi(argv[i]));
+    if (threadCounts.empty())
+        threadCounts = {1, 2, 4, 8, 16};
+
+    std::vector<GameModel> models;
+    uint64_t seed = 1;
+    while ((int)models.size() < POSITION_COUNT)
+    {
+        GameModel model;
+        playRandomOpening(model, seed);
+        if (!model.gameOver)
+            models.push_back(model);
+    }
+
+    printf("depth %d, %d positions, %s\n",
+           depth,
+           POSITION_COUNT,
+           (parallelSearch == PARALLEL_ROOT_SPLIT) ? "root split" : "lazy SMP");
+    printf("threads      time (s)      nodes   nodes/s   speedup  same move\n");
+
+    double baseTime = 0;
+    std::vector<Square> baseMoves;
+    for (int threadCount : threadCounts)
+    {
+        double time = 0;
+        uint64_t nodes = 0;
+        int sameMoves = 0;
+
+        for (size_t i = 0; i < models.size(); i++)
+        {
+            GameModel &model = models[i];
+
+            SearchLimits limits;
+            initSearchLimits(limits);
+            limits.maxDepth = depth;
+            limits.gameTime = 1e9;
+            limits.threadCount = threadCount;
+            limits.parallelSearch = parallelSearch;
+
+            // Cada búsqueda empieza con la tabla vacía
+            clearTranspositionTable(getSharedTranspositionTable());
+
+            SearchInfo info;
+            Square move = getBestMove(model, limits, info);
+
+            time += info.time;
+            nodes += info.nodes;
+
+            if (baseMoves.size() < models.size())
+                baseMoves.push_back(move);
+            sameMoves += (move.x == baseMoves[i].x) && (move.y == baseMoves[i].y);
+        }
+
+        if (baseTime == 0)
+            baseTime = time;
+
+        printf("%7d %13.3f %10llu %9.0f %9.2f %6d/%d\n",
+               threadCount,
+               time,
+               (unsigned long long)nodes,
+               nodes / time,
+               baseTime / time,
+               sameMoves,
+               (int)models.size());
+    }
+
+    return 0;
+}
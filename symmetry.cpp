@@ -0,0 +1,80 @@
+/**
+ * @brief Implements the board symmetries
+ *
+ * @copyright Copyright (c) 2023-2024
+ */
+
+#include <utility>
+
+#include "model.h"
+#include "symmetry.h"
+
+/**
+ * @brief Computes a bitboard in all 8 orientations.
+ *
+ * @param bitboard The bitboard.
+ * @param transformed Receives the bitboard transformed by each symmetry.
+ */
+static inline void transformAll(Bitboard bitboard, Bitboard transformed[SYMMETRY_COUNT])
+{
+    // Las reflexiones conmutan: cada orientación reusa otra ya calculada
+    Bitboard transposed = transposeBitboard(bitboard);
+
+    transformed[0] = bitboard;
+    transformed[1] = mirrorBitboard(bitboard);
+    transformed[2] = flipBitboard(bitboard);
+    transformed[3] = flipBitboard(transformed[1]);
+    transformed[4] = transposed;
+    transformed[5] = mirrorBitboard(transposed);
+    transformed[6] = flipBitboard(transposed);
+    transformed[7] = flipBitboard(transformed[5]);
+}
+
+Position getCanonicalPosition(Position &position, int &symmetry)
+{
+    Bitboard player[SYMMETRY_COUNT];
+    Bitboard opponent[SYMMETRY_COUNT];
+    transformAll(position.player, player);
+    transformAll(position.opponent, opponent);
+
+    symmetry = 0;
+    for (int i = 1; i < SYMMETRY_COUNT; i++)
+    {
+        if ((player[i] < player[symmetry]) ||
+            ((player[i] == player[symmetry]) && (opponent[i] < opponent[symmetry])))
+            symmetry = i;
+    }
+
+    return {player[symmetry], opponent[symmetry]};
+}
+
+int transformSquare(int square, int symmetry)
+{
+    int x = square % BOARD_SIZE;
+    int y = square / BOARD_SIZE;
+
+    if (symmetry & 4)
+        std::swap(x, y);
+    if (symmetry & 2)
+        y = BOARD_SIZE - 1 - y;
+    if (symmetry & 1)
+        x = BOARD_SIZE - 1 - x;
+
+    return y * BOARD_SIZE + x;
+}
+
+int untransformSquare(int square, int symmetry)
+{
+    int x = square % BOARD_SIZE;
+    int y = square / BOARD_SIZE;
+
+    // Las mismas operaciones en el orden inverso
+    if (symmetry & 1)
+        x = BOARD_SIZE - 1 - x;
+    if (symmetry & 2)
+        y = BOARD_SIZE - 1 - y;
+    if (symmetry & 4)
+        std::swap(x, y);
+
+    return y * BOARD_SIZE + x;
+}
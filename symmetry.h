@@ -0,0 +1,115 @@
+/**
+ * @brief Implements the board symmetries
+ *
+ * The board has 8 symmetries. Symmetry s applies, in this order, a
+ * reflection over the main diagonal if bit 2 is set, a reflection over
+ * the horizontal axis if bit 1 is set and a reflection over the vertical
+ * axis if bit 0 is set.
+ *
+ * @copyright Copyright (c) 2023-2024
+ */
+
+#ifndef SYMMETRY_H
+#define SYMMETRY_H
+
+#include "bitboard.h"
+
+#define SYMMETRY_COUNT 8
+
+/**
+ * @brief Reflects a bitboard over the vertical axis (x becomes 7 - x).
+ *
+ * @param bitboard The bitboard.
+ * @return The reflected bitboard.
+ */
+inline Bitboard mirrorBitboard(Bitboard bitboard)
+{
+    bitboard = ((bitboard >> 1) & 0x5555555555555555ULL) | ((bitboard & 0x5555555555555555ULL) << 1);
+    bitboard = ((bitboard >> 2) & 0x3333333333333333ULL) | ((bitboard & 0x3333333333333333ULL) << 2);
+    bitboard = ((bitboard >> 4) & 0x0f0f0f0f0f0f0f0fULL) | ((bitboard & 0x0f0f0f0f0f0f0f0fULL) << 4);
+
+    return bitboard;
+}
+
+/**
+ * @brief Reflects a bitboard over the horizontal axis (y becomes 7 - y).
+ *
+ * @param bitboard The bitboard.
+ * @return The reflected bitboard.
+ */
+inline Bitboard flipBitboard(Bitboard bitboard)
+{
+    return __builtin_bswap64(bitboard);
+}
+
+/**
+ * @brief Reflects a bitboard over the main diagonal (x and y swap).
+ *
+ * @param bitboard The bitboard.
+ * @return The reflected bitboard.
+ */
+inline Bitboard transposeBitboard(Bitboard bitboard)
+{
+    // Se intercambian bloques de 4x4, después de 2x2 y después casillas
+    Bitboard t;
+    t = 0x0f0f0f0f00000000ULL & (bitboard ^ (bitboard << 28));
+    bitboard ^= t ^ (t >> 28);
+    t = 0x3333000033330000ULL & (bitboard ^ (bitboard << 14));
+    bitboard ^= t ^ (t >> 14);
+    t = 0x5500550055005500ULL & (bitboard ^ (bitboard << 7));
+    bitboard ^= t ^ (t >> 7);
+
+    return bitboard;
+}
+
+/**
+ * @brief Applies a symmetry to a bitboard.
+ *
+ * @param bitboard The bitboard.
+ * @param symmetry The symmetry (0 to 7).
+ * @return The transformed bitboard.
+ */
+inline Bitboard transformBitboard(Bitboard bitboard, int symmetry)
+{
+    if (symmetry & 4)
+        bitboard = transposeBitboard(bitboard);
+    if (symmetry & 2)
+        bitboard = flipBitboard(bitboard);
+    if (symmetry & 1)
+        bitboard = mirrorBitboard(bitboard);
+
+    return bitboard;
+}
+
+/**
+ * @brief Returns the canonical orientation of a position.
+ *
+ * The canonical orientation is the smallest of the 8, comparing the
+ * discs of the side to move first, so all symmetric positions share it.
+ *
+ * @param position The position.
+ * @param symmetry Receives the symmetry that takes the position to its
+ * canonical orientation (the lowest one, if several do).
+ * @return The position in its canonical orientation.
+ */
+Position getCanonicalPosition(Position &position, int &symmetry);
+
+/**
+ * @brief Applies a symmetry to a square.
+ *
+ * @param square The square index.
+ * @param symmetry The symmetry (0 to 7).
+ * @return The square index in the transformed position.
+ */
+int transformSquare(int square, int symmetry);
+
+/**
+ * @brief Takes a square back from a transformed position.
+ *
+ * @param square The square index in the transformed position.
+ * @param symmetry The symmetry (0 to 7).
+ * @return The square index in the original position.
+ */
+int untransformSquare(int square, int symmetry);
+
+#endif
@@ -0,0 +1,120 @@
+/**
+ * @brief Implements a pool of worker threads for the AI's search
+ *
+ * @copyright Copyright (c) 2023-2024
+ */
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "threadpool.h"
+#include "trace.h"
+
+/**
+ * @brief The pool's threads and the task they are running.
+ */
+static struct ThreadPool
+{
+    std::vector<std::thread> threads;
+    std::mutex runMutex; // Una tarea a la vez
+    std::mutex mutex;
+    std::condition_variable taskReady;
+    std::condition_variable taskDone;
+
+    const std::function<void(int)> *task = nullptr;
+    unsigned generation = 0;
+    int threadCount = 0;
+    int running = 0;
+    bool quit = false;
+
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            quit = true;
+        }
+        taskReady.notify_all();
+
+        for (auto &thread : threads)
+            thread.join();
+    }
+} threadPool;
+
+/**
+ * @brief Runs the tasks of the pool on one of its threads.
+ *
+ * @param threadIndex The thread index (1 or more).
+ */
+static void runWorker(int threadIndex)
+{
+    TRACE_THREAD_NAME("worker");
+
+    unsigned generation = 0;
+
+    while (true)
+    {
+        const std::function<void(int)> *task;
+        {
+            std::unique_lock<std::mutex> lock(threadPool.mutex);
+            threadPool.taskReady.wait(lock, [&]
+                                      { return threadPool.quit ||
+                                               (threadPool.generation != generation); });
+            if (threadPool.quit)
+                return;
+
+            generation = threadPool.generation;
+            if (threadIndex >= threadPool.threadCount)
+                continue;
+
+            task = threadPool.task;
+        }
+
+        (*task)(threadIndex);
+
+        {
+            std::lock_guard<std::mutex> lock(threadPool.mutex);
+            threadPool.running--;
+        }
+        threadPool.taskDone.notify_one();
+    }
+}
+
+int getHardwareThreadCount()
+{
+    int threadCount = (int)std::thread::hardware_concurrency();
+
+    return (threadCount > 0) ? threadCount : 1;
+}
+
+void runThreadPool(int threadCount, const std::function<void(int)> &task)
+{
+    // Con un solo hilo no se usa el grupo, así una tarea puede hacer
+    // búsquedas de un hilo dentro de otra tarea del grupo
+    if (threadCount <= 1)
+    {
+        task(0);
+        return;
+    }
+
+    std::lock_guard<std::mutex> runLock(threadPool.runMutex);
+    {
+        std::lock_guard<std::mutex> lock(threadPool.mutex);
+
+        while ((int)threadPool.threads.size() < threadCount - 1)
+            threadPool.threads.emplace_back(runWorker, (int)threadPool.threads.size() + 1);
+
+        threadPool.task = &task;
+        threadPool.threadCount = threadCount;
+        threadPool.running = threadCount - 1;
+        threadPool.generation++;
+    }
+    threadPool.taskReady.notify_all();
+
+    task(0);
+
+    std::unique_lock<std::mutex> lock(threadPool.mutex);
+    threadPool.taskDone.wait(lock, []
+                             { return threadPool.running == 0; });
+}
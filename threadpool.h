@@ -0,0 +1,32 @@
+/**
+ * @brief Implements a pool of worker threads for the AI's search
+ *
+ * @copyright Copyright (c) 2023-2024
+ */
+
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <functional>
+
+/**
+ * @brief Returns the number of hardware threads.
+ *
+ * @return The number of threads (at least 1).
+ */
+int getHardwareThreadCount();
+
+/**
+ * @brief Runs a task on several threads and waits until all finish.
+ *
+ * The calling thread runs the task as thread 0; the pool's threads,
+ * started on first use and kept for later calls, run the rest. Calls
+ * from several threads run one after another, so a task may only call
+ * this function with one thread.
+ *
+ * @param threadCount The number of threads, including the calling one.
+ * @param task The task. Receives the thread index.
+ */
+void runThreadPool(int threadCount, const std::function<void(int)> &task);
+
+#endif
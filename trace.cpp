@@ -0,0 +1,235 @@
+/**
+ * @brief Records a timeline of the engine's activity as trace events
+ *
+ * @copyright Copyright (c) 2023-2024
+ */
+
+#include <atomic>
+#include <cstdio>
+#include <mutex>
+#include <vector>
+
+#include "model.h"
+#include "trace.h"
+
+// Eventos que guarda cada hilo (32 bytes cada uno: 2 MiB por hilo)
+#define TRACE_BUFFER_SIZE (1 << 16)
+
+// Duración de los instantes
+#define TRACE_INSTANT -1.0
+
+/**
+ * @brief A recorded event.
+ */
+struct TraceRecord
+{
+    const char *name;
+    int64_t value;
+    double startTime;
+    double duration; // En segundos, o TRACE_INSTANT
+};
+
+static_assert(sizeof(TraceRecord) == 32, "TRACE_BUFFER_SIZE assumes 32-byte records");
+
+/**
+ * @brief The ring buffer of a thread.
+ *
+ * Only its thread writes it. When the thread ends, the buffer is free
+ * for the next thread that starts, and keeps its events. The count is
+ * published after each record, so writeTrace reads only whole records.
+ */
+struct TraceBuffer
+{
+    TraceRecord records[TRACE_BUFFER_SIZE];
+    std::atomic<uint64_t> count; // Eventos registrados desde el principio
+    int threadId;
+    const char *threadName;
+    bool owned;
+};
+
+/**
+ * @brief The buffers of all threads.
+ *
+ * Never destroyed: threads of other static objects may record events
+ * while the program exits.
+ */
+struct Trace
+{
+    std::mutex mutex;
+    std::vector<TraceBuffer *> buffers;
+};
+
+/**
+ * @brief Releases the buffer of a thread when the thread ends.
+ */
+struct TraceThread
+{
+    TraceBuffer *buffer = nullptr;
+
+    ~TraceThread();
+};
+
+static thread_local TraceThread traceThread;
+
+/**
+ * @brief Returns the trace.
+ *
+ * @return The trace.
+ */
+static Trace &getTrace()
+{
+    static Trace *trace = new Trace;
+
+    return *trace;
+}
+
+TraceThread::~TraceThread()
+{
+    if (!buffer)
+        return;
+
+    Trace &trace = getTrace();
+    std::lock_guard<std::mutex> lock(trace.mutex);
+    buffer->owned = false;
+}
+
+/**
+ * @brief Returns the buffer of the calling thread.
+ *
+ * @return The buffer.
+ */
+static TraceBuffer &getTraceBuffer()
+{
+    if (traceThread.buffer)
+        return *traceThread.buffer;
+
+    Trace &trace = getTrace();
+    std::lock_guard<std::mutex> lock(trace.mutex);
+
+    // Se reusa el de un hilo que terminó
+    for (TraceBuffer *buffer : trace.buffers)
+    {
+        if (!buffer->owned)
+        {
+            buffer->owned = true;
+            traceThread.buffer = buffer;
+            return *buffer;
+        }
+    }
+
+    TraceBuffer *buffer = new TraceBuffer;
+    buffer->count = 0;
+    buffer->threadId = (int)trace.buffers.size() + 1;
+    buffer->threadName = nullptr;
+    buffer->owned = true;
+    trace.buffers.push_back(buffer);
+    traceThread.buffer = buffer;
+
+    return *buffer;
+}
+
+/**
+ * @brief Records an event of the calling thread.
+ *
+ * @param name The event name.
+ * @param value A value shown with the event, or TRACE_NO_VALUE.
+ * @param startTime The start of the event.
+ * @param duration The duration of the event, or TRACE_INSTANT.
+ */
+static void addTraceRecord(const char *name, int64_t value, double startTime, double duration)
+{
+    TraceBuffer &buffer = getTraceBuffer();
+    uint64_t count = buffer.count.load(std::memory_order_relaxed);
+
+    TraceRecord &record = buffer.records[count % TRACE_BUFFER_SIZE];
+    record.name = name;
+    record.value = value;
+    record.startTime = startTime;
+    record.duration = duration;
+    buffer.count.store(count + 1, std::memory_order_release);
+}
+
+double getTraceTime()
+{
+    return getClockTime();
+}
+
+void addTraceSpan(const char *name, int64_t value, double startTime)
+{
+    addTraceRecord(name, value, startTime, getClockTime() - startTime);
+}
+
+void addTraceEvent(const char *name, int64_t value)
+{
+    addTraceRecord(name, value, getClockTime(), TRACE_INSTANT);
+}
+
+void setTraceThreadName(const char *name)
+{
+    TraceBuffer &buffer = getTraceBuffer();
+
+    // writeTrace lee el nombre con el lock tomado
+    std::lock_guard<std::mutex> lock(getTrace().mutex);
+    buffer.threadName = name;
+}
+
+bool writeTrace(const char *path)
+{
+    FILE *file = fopen(path, "w");
+    if (!file)
+        return false;
+
+    Trace &trace = getTrace();
+    std::lock_guard<std::mutex> lock(trace.mutex);
+
+    fprintf(file, "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n");
+
+    bool first = true;
+    for (TraceBuffer *buffer : trace.buffers)
+    {
+        if (buffer->threadName)
+        {
+            fprintf(file,
+                    "%s{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": %d, "
+                    "\"args\": {\"name\": \"%s\"}}",
+                    first ? "" : ",\n",
+                    buffer->threadId,
+                    buffer->threadName);
+            first = false;
+        }
+
+        // Solo quedan los últimos eventos del buffer
+        uint64_t count = buffer->count.load(std::memory_order_acquire);
+        uint64_t firstRecord = (count > TRACE_BUFFER_SIZE) ? (count - TRACE_BUFFER_SIZE) : 0;
+        for (uint64_t i = firstRecord; i < count; i++)
+        {
+            TraceRecord &record = buffer->records[i % TRACE_BUFFER_SIZE];
+            double timestamp = record.startTime * 1e6;
+
+            if (record.duration == TRACE_INSTANT)
+                fprintf(file,
+                        "%s{\"name\": \"%s\", \"ph\": \"i\", \"s\": \"t\", \"pid\": 1, \"tid\": %d, \"ts\": %.3f",
+                        first ? "" : ",\n",
+                        record.name,
+                        buffer->threadId,
+                        timestamp);
+            else
+                fprintf(file,
+                        "%s{\"name\": \"%s\", \"ph\": \"X\", \"pid\": 1, \"tid\": %d, \"ts\": %.3f, \"dur\": %.3f",
+                        first ? "" : ",\n",
+                        record.name,
+                        buffer->threadId,
+                        timestamp,
+                        record.duration * 1e6);
+
+            if (record.value != TRACE_NO_VALUE)
+                fprintf(file, ", \"args\": {\"value\": %lld}", (long long)record.value);
+            fprintf(file, "}");
+            first = false;
+        }
+    }
+
+    fprintf(file, "\n]}\n");
+
+    return !fclose(file);
+}
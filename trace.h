@@ -0,0 +1,110 @@
+/**
+ * @brief Records a timeline of the engine's activity as trace events
+ *
+ * Built with EDAVERSI_TRACE, TRACE_SCOPE and TRACE_EVENT record events in
+ * a ring buffer of the calling thread, and writeTrace saves them in the
+ * Chrome trace event format (chrome://tracing, ui.perfetto.dev). Built
+ * without it, the macros expand to nothing.
+ *
+ * @copyright Copyright (c) 2023-2024
+ */
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <cstdint>
+
+// Valor de los eventos sin argumento
+#define TRACE_NO_VALUE INT64_MIN
+
+#ifdef EDAVERSI_TRACE
+
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+
+// Registra la duración del resto del bloque. El nombre debe ser constante
+#define TRACE_SCOPE(name) TraceScope TRACE_CONCAT(traceScope, __LINE__)(name, TRACE_NO_VALUE)
+#define TRACE_SCOPE_VALUE(name, value) TraceScope TRACE_CONCAT(traceScope, __LINE__)(name, value)
+// Registra un instante
+#define TRACE_EVENT(name) addTraceEvent(name, TRACE_NO_VALUE)
+#define TRACE_EVENT_VALUE(name, value) addTraceEvent(name, value)
+// Nombra la fila del hilo en el visor
+#define TRACE_THREAD_NAME(name) setTraceThreadName(name)
+
+#else
+
+#define TRACE_SCOPE(name)
+#define TRACE_SCOPE_VALUE(name, value)
+#define TRACE_EVENT(name)
+#define TRACE_EVENT_VALUE(name, value)
+#define TRACE_THREAD_NAME(name)
+
+#endif
+
+/**
+ * @brief Returns the time of the trace clock.
+ *
+ * @return The time, in seconds.
+ */
+double getTraceTime();
+
+/**
+ * @brief Records a span of the calling thread.
+ *
+ * @param name The event name, which must outlive the trace.
+ * @param value A value shown with the event, or TRACE_NO_VALUE.
+ * @param startTime The start of the span, from getTraceTime.
+ */
+void addTraceSpan(const char *name, int64_t value, double startTime);
+
+/**
+ * @brief Records an instant of the calling thread.
+ *
+ * @param name The event name, which must outlive the trace.
+ * @param value A value shown with the event, or TRACE_NO_VALUE.
+ */
+void addTraceEvent(const char *name, int64_t value);
+
+/**
+ * @brief Names the calling thread in the trace.
+ *
+ * A thread that starts after another one ended may take its buffer,
+ * and with it its name and its row in the viewer.
+ *
+ * @param name The thread name, which must outlive the trace.
+ */
+void setTraceThreadName(const char *name);
+
+/**
+ * @brief Writes the recorded events in the Chrome trace event format.
+ *
+ * Each thread keeps only its most recent events. The threads that record
+ * events must be idle, as after stopping the AI's search: a thread that
+ * keeps recording may overwrite its oldest events while they are read.
+ *
+ * @param path The path of the trace file.
+ * @return The file was written.
+ */
+bool writeTrace(const char *path);
+
+/**
+ * @brief Records a span from its construction to its destruction.
+ */
+struct TraceScope
+{
+    const char *name;
+    int64_t value;
+    double startTime;
+
+    TraceScope(const char *name, int64_t value)
+        : name(name), value(value), startTime(getTraceTime())
+    {
+    }
+
+    ~TraceScope()
+    {
+        addTraceSpan(name, value, startTime);
+    }
+};
+
+#endif
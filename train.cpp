@@ -0,0 +1,233 @@
+/**
+ * @brief Trains the pattern evaluation weights
+ *
+ * Usage: edaversi_train [games [output]]
+ *
+ * Plays games with a shallow heuristic search and some random moves,
+ * solves them exactly from LABEL_EMPTIES empties on, and fits the pattern
+ * weights of each phase to the exact final scores with stochastic
+ * gradient descent. Every other position takes the score of the next
+ * solved position in its game.
+ *
+ * @copyright Copyright (c) 2023-2024
+ */
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "ai.h"
+#include "pattern.h"
+#include "transposition.h"
+
+#define DEFAULT_GAMES 5000
+#define DEFAULT_OUTPUT "edaversi.weights"
+
+// Jugadas al azar al principio de cada partida
+#define RANDOM_PLIES 8
+// Después, una jugada de cada tantas también es al azar
+#define RANDOM_MOVE_ODDS 10
+#define TRAINING_SEARCH_DEPTH 4
+// Desde aquí las partidas se resuelven exactamente
+#define LABEL_EMPTIES 14
+
+#define EPOCHS 20
+#define LEARNING_RATE 0.002f
+
+/**
+ * @brief A training position, with its final score for black.
+ */
+struct TrainingPosition
+{
+    Bitboard black;
+    Bitboard white;
+    int emptyCount;
+    int score;
+    bool solved;
+};
+
+/**
+ * @brief Returns a pseudo-random number.
+ *
+ * @param seed The generator state.
+ * @return The number.
+ */
+static uint32_t getRandom(uint64_t &seed)
+{
+    seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+
+    return (uint32_t)(seed >> 33);
+}
+
+/**
+ * @brief Plays a training game and adds its positions.
+ *
+ * @param seed The random generator state.
+ * @param positions The training positions.
+ */
+static void playTrainingGame(uint64_t &seed, std::vector<TrainingPosition> &positions)
+{
+    GameModel model;
+    initModel(model);
+    startModel(model);
+
+    SearchLimits limits;
+    initSearchLimits(limits);
+    limits.gameTime = 1e9;
+    limits.threadCount = 1;
+    limits.evaluator = EVALUATOR_HEURISTIC;
+
+    size_t firstPosition = positions.size();
+    for (int ply = 0; !model.gameOver; ply++)
+    {
+        TrainingPosition trainingPosition;
+        trainingPosition.black = model.discs[PLAYER_BLACK];
+        trainingPosition.white = model.discs[PLAYER_WHITE];
+        trainingPosition.emptyCount = BOARD_SIZE * BOARD_SIZE -
+                                      countBits(trainingPosition.black | trainingPosition.white);
+        trainingPosition.score = 0;
+        trainingPosition.solved = false;
+
+        Moves validMoves;
+        getValidMoves(model, validMoves);
+
+        Square move;
+        if (trainingPosition.emptyCount <= LABEL_EMPTIES)
+        {
+            // Juego perfecto: cada posición vale el resultado exacto
+            limits.maxDepth = trainingPosition.emptyCount;
+            limits.endgameEmpties = trainingPosition.emptyCount;
+
+            SearchInfo info;
+            move = getBestMove(model, limits, info);
+
+            // Con una sola jugada no se busca: vale lo que la posición siguiente
+            if (validMoves.size() > 1)
+            {
+                trainingPosition.score = (model.currentPlayer == PLAYER_BLACK) ? info.score : -info.score;
+                trainingPosition.solved = true;
+            }
+        }
+        else if ((ply < RANDOM_PLIES) || !(getRandom(seed) % RANDOM_MOVE_ODDS))
+            move = validMoves[getRandom(seed) % validMoves.size()];
+        else
+        {
+            limits.maxDepth = TRAINING_SEARCH_DEPTH;
+            limits.endgameEmpties = 0;
+            move = getBestMove(model, limits);
+        }
+
+        positions.push_back(trainingPosition);
+        playMove(model, move);
+    }
+
+    // Cada posición sin resolver toma el valor de la siguiente resuelta, o el
+    // resultado de la partida
+    Position final = {model.discs[PLAYER_BLACK], model.discs[PLAYER_WHITE]};
+    int score = getFinalScore(final);
+    for (size_t i = positions.size(); i-- > firstPosition;)
+    {
+        if (positions[i].solved)
+            score = positions[i].score;
+        else
+            positions[i].score = score;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    int gameCount = (argc > 1) ? atoi(argv[1]) : DEFAULT_GAMES;
+    const char *output = (argc > 2) ? argv[2] : DEFAULT_OUTPUT;
+
+    std::vector<TrainingPosition> positions;
+    uint64_t seed = 1;
+    double startTime = getClockTime();
+    for (int i = 0; i < gameCount; i++)
+    {
+        playTrainingGame(seed, positions);
+
+        if (((i + 1) % 100) == 0)
+        {
+            printf("\r%d games, %zu positions, %.0f s", i + 1, positions.size(), getClockTime() - startTime);
+            fflush(stdout);
+        }
+    }
+    printf("\n");
+
+    // Las características de cada posición se calculan una sola vez
+    std::vector<uint32_t> features(positions.size() * PATTERN_INSTANCE_COUNT);
+    std::vector<int> phases(positions.size());
+    for (size_t i = 0; i < positions.size(); i++)
+    {
+        Position position = {positions[i].black, positions[i].white};
+        PatternIndices patterns;
+        initPatternIndices(position, PLAYER_BLACK, patterns);
+        getPatternFeatures(patterns, &features[i * PATTERN_INSTANCE_COUNT]);
+        phases[i] = getPatternPhase(positions[i].emptyCount);
+    }
+
+    std::vector<float> weights((size_t)PATTERN_PHASE_COUNT * PATTERN_WEIGHT_COUNT, 0.0F);
+    for (int phase = 0; phase < PATTERN_PHASE_COUNT; phase++)
+    {
+        float *phaseWeights = &weights[(size_t)phase * PATTERN_WEIGHT_COUNT];
+
+        // Cada fase también aprende de las vecinas, que tienen posiciones parecidas
+        std::vector<size_t> samples;
+        for (size_t i = 0; i < positions.size(); i++)
+        {
+            if (std::abs(phases[i] - phase) <= 1)
+                samples.push_back(i);
+        }
+
+        double error = 0;
+        for (int epoch = 0; epoch < EPOCHS; epoch++)
+        {
+            // Se recorren las muestras en otro orden en cada época
+            for (size_t i = samples.size(); i > 1; i--)
+                std::swap(samples[i - 1], samples[getRandom(seed) % i]);
+
+            // El paso se achica en cada época, para que los pesos que
+            // comparten muchas posiciones se asienten en su promedio
+            float learningRate = LEARNING_RATE * (EPOCHS - epoch) / EPOCHS;
+
+            error = 0;
+            for (size_t sample : samples)
+            {
+                uint32_t *sampleFeatures = &features[sample * PATTERN_INSTANCE_COUNT];
+
+                float prediction = 0;
+                for (int j = 0; j < PATTERN_INSTANCE_COUNT; j++)
+                    prediction += phaseWeights[sampleFeatures[j]];
+
+                float delta = positions[sample].score - prediction;
+                error += delta * delta;
+
+                for (int j = 0; j < PATTERN_INSTANCE_COUNT; j++)
+                    phaseWeights[sampleFeatures[j]] += learningRate * delta;
+            }
+        }
+
+        printf("phase %2d: %zu positions, rms error %.2f discs\n",
+               phase,
+               samples.size(),
+               samples.empty() ? 0.0 : sqrt(error / samples.size()));
+    }
+
+    std::vector<int16_t> scaledWeights(weights.size());
+    for (size_t i = 0; i < weights.size(); i++)
+    {
+        float weight = roundf(weights[i] * PATTERN_WEIGHT_SCALE);
+        weight = (weight > INT16_MAX) ? INT16_MAX : ((weight < INT16_MIN) ? INT16_MIN : weight);
+        scaledWeights[i] = (int16_t)weight;
+    }
+
+    if (!savePatternWeights(output, scaledWeights.data()))
+    {
+        fprintf(stderr, "Could not write %s\n", output);
+        return 1;
+    }
+    printf("Wrote %s\n", output);
+
+    return 0;
+}
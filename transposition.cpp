@@ -0,0 +1,238 @@
+/**
+ * @brief Implements Zobrist hashing and the transposition table
+ *
+ * @copyright Copyright (c) 2023-2024
+ */
+
+#include <atomic>
+
+#include "transposition.h"
+
+// 2^20 entradas de 16 bytes (16 MB), en cubetas de 2
+#define TT_SIZE_BITS 20
+#define TT_SIZE (1 << TT_SIZE_BITS)
+#define TT_BUCKET_SIZE 2
+
+/**
+ * @brief Random keys for every (colour, square) pair and for the side to move.
+ */
+static struct ZobristKeys
+{
+    uint64_t squares[2][BOARD_SIZE * BOARD_SIZE];
+    uint64_t flips[BOARD_SIZE * BOARD_SIZE];
+    uint64_t player;
+
+    ZobristKeys()
+    {
+        // splitmix64 con semilla fija, para que las claves sean reproducibles
+        uint64_t seed = 0x45444176657273ULL;
+        for (int i = 0; i < 2 * BOARD_SIZE * BOARD_SIZE + 1; i++)
+        {
+            uint64_t z = (seed += 0x9e3779b97f4a7c15ULL);
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+            z ^= z >> 31;
+
+            if (i < 2 * BOARD_SIZE * BOARD_SIZE)
+                squares[i / (BOARD_SIZE * BOARD_SIZE)][i % (BOARD_SIZE * BOARD_SIZE)] = z;
+            else
+                player = z;
+        }
+
+        // Dar vuelta una ficha cambia su color
+        for (int i = 0; i < BOARD_SIZE * BOARD_SIZE; i++)
+            flips[i] = squares[PLAYER_BLACK][i] ^ squares[PLAYER_WHITE][i];
+    }
+} zobristKeys;
+
+/**
+ * @brief A table entry, shared without locks between the search threads.
+ *
+ * The entry's data is packed into one word and stored next to the key
+ * XORed with it. A reader that sees half of a concurrent write gets a
+ * key that does not match, and treats the entry as missing.
+ */
+struct TTSlot
+{
+    std::atomic<uint64_t> check;
+    std::atomic<uint64_t> data;
+};
+
+struct TranspositionTable
+{
+    TTSlot *slots;
+    uint64_t size;
+    // Búsquedas simultáneas con la misma tabla la avanzan a la vez
+    std::atomic<uint8_t> age;
+};
+
+static TTSlot sharedSlots[TT_SIZE];
+static TranspositionTable sharedTable = {sharedSlots, TT_SIZE, {0}};
+
+/**
+ * @brief Packs an entry's data into one word.
+ *
+ * @param entry The entry.
+ * @return The packed data.
+ */
+static uint64_t packEntry(TTEntry &entry)
+{
+    return (uint64_t)(uint32_t)entry.score |
+           ((uint64_t)(uint8_t)entry.depth << 32) |
+           ((uint64_t)entry.bound << 40) |
+           ((uint64_t)(uint8_t)entry.move << 48) |
+           ((uint64_t)entry.age << 56);
+}
+
+/**
+ * @brief Unpacks an entry's data packed with packEntry.
+ *
+ * @param data The packed data.
+ * @param entry Receives the entry's data.
+ */
+static void unpackEntry(uint64_t data, TTEntry &entry)
+{
+    entry.score = (int32_t)(uint32_t)data;
+    entry.depth = (int8_t)(data >> 32);
+    entry.bound = (uint8_t)(data >> 40);
+    entry.move = (int8_t)(data >> 48);
+    entry.age = (uint8_t)(data >> 56);
+}
+
+uint64_t getHashKey(Position &position, Player player)
+{
+    Player opponent = getOpponent(player);
+    uint64_t key = (player == PLAYER_WHITE) ? zobristKeys.player : 0;
+
+    for (Bitboard discs = position.player; discs; discs &= discs - 1)
+        key ^= zobristKeys.squares[player][getFirstBit(discs)];
+    for (Bitboard discs = position.opponent; discs; discs &= discs - 1)
+        key ^= zobristKeys.squares[opponent][getFirstBit(discs)];
+
+    return key;
+}
+
+uint64_t getMoveHashKey(Player player, int square, Bitboard flips)
+{
+    uint64_t key = zobristKeys.squares[player][square] ^ zobristKeys.player;
+
+    for (; flips; flips &= flips - 1)
+        key ^= zobristKeys.flips[getFirstBit(flips)];
+
+    return key;
+}
+
+uint64_t getPassHashKey()
+{
+    return zobristKeys.player;
+}
+
+TranspositionTable *createTranspositionTable(int sizeBits)
+{
+    TranspositionTable *table = new TranspositionTable;
+    table->size = 1ULL << sizeBits;
+    table->slots = new TTSlot[table->size];
+    clearTranspositionTable(table);
+
+    return table;
+}
+
+void freeTranspositionTable(TranspositionTable *table)
+{
+    delete[] table->slots;
+    delete table;
+}
+
+TranspositionTable *getSharedTranspositionTable()
+{
+    return &sharedTable;
+}
+
+bool probeTranspositionTable(TranspositionTable *table, uint64_t key, TTEntry &entry)
+{
+    TTSlot *bucket = &table->slots[key & (table->size - TT_BUCKET_SIZE)];
+
+    for (int i = 0; i < TT_BUCKET_SIZE; i++)
+    {
+        uint64_t data = bucket[i].data.load(std::memory_order_relaxed);
+        uint64_t check = bucket[i].check.load(std::memory_order_relaxed);
+
+        if ((check ^ data) == key)
+        {
+            entry.key = key;
+            unpackEntry(data, entry);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void storeTranspositionTable(TranspositionTable *table, uint64_t key, int depth, int score, TTBound bound, int move)
+{
+    TTSlot *bucket = &table->slots[key & (table->size - TT_BUCKET_SIZE)];
+
+    uint8_t age = table->age.load(std::memory_order_relaxed);
+
+    // Se reemplaza la misma posición, o si no la entrada más vieja y menos profunda
+    TTSlot *slot = &bucket[0];
+    TTEntry old;
+    bool found = false;
+    for (int i = 0; i < TT_BUCKET_SIZE; i++)
+    {
+        uint64_t data = bucket[i].data.load(std::memory_order_relaxed);
+        uint64_t check = bucket[i].check.load(std::memory_order_relaxed);
+
+        TTEntry candidate;
+        unpackEntry(data, candidate);
+
+        if ((check ^ data) == key)
+        {
+            slot = &bucket[i];
+            old = candidate;
+            found = true;
+            break;
+        }
+
+        if ((i == 0) ||
+            ((candidate.age == age) < (old.age == age)) ||
+            (((candidate.age == age) == (old.age == age)) &&
+             (candidate.depth < old.depth)))
+        {
+            slot = &bucket[i];
+            old = candidate;
+        }
+    }
+
+    // Se conserva la jugada de una búsqueda anterior si esta no encontró ninguna
+    if ((move == TT_NO_MOVE) && found)
+        move = old.move;
+
+    TTEntry entry;
+    entry.key = key;
+    entry.score = score;
+    entry.depth = (int8_t)depth;
+    entry.bound = (uint8_t)bound;
+    entry.move = (int8_t)move;
+    entry.age = age;
+
+    uint64_t data = packEntry(entry);
+    slot->data.store(data, std::memory_order_relaxed);
+    slot->check.store(key ^ data, std::memory_order_relaxed);
+}
+
+void ageTranspositionTable(TranspositionTable *table)
+{
+    table->age.fetch_add(1, std::memory_order_relaxed);
+}
+
+void clearTranspositionTable(TranspositionTable *table)
+{
+    for (uint64_t i = 0; i < table->size; i++)
+    {
+        table->slots[i].data.store(0, std::memory_order_relaxed);
+        table->slots[i].check.store(0, std::memory_order_relaxed);
+    }
+
+    table->age = 0;
+}
@@ -0,0 +1,126 @@
+/**
+ * @brief Implements Zobrist hashing and the transposition table
+ *
+ * @copyright Copyright (c) 2023-2024
+ */
+
+#ifndef TRANSPOSITION_H
+#define TRANSPOSITION_H
+
+#include <cstdint>
+
+#include "model.h"
+
+#define TT_NO_MOVE -1
+
+enum TTBound
+{
+    TT_BOUND_EXACT,
+    TT_BOUND_LOWER,
+    TT_BOUND_UPPER,
+};
+
+/**
+ * @brief A searched position.
+ */
+struct TTEntry
+{
+    uint64_t key;
+    int32_t score;
+    int8_t depth;
+    uint8_t bound;
+    int8_t move;
+    uint8_t age;
+};
+
+/**
+ * @brief A table of searched positions, shared without locks between the
+ * threads of a search.
+ */
+struct TranspositionTable;
+
+/**
+ * @brief Creates an empty transposition table.
+ *
+ * @param sizeBits The base 2 logarithm of the number of entries (at least 1).
+ * @return The table.
+ */
+TranspositionTable *createTranspositionTable(int sizeBits);
+
+/**
+ * @brief Frees a table created with createTranspositionTable.
+ *
+ * @param table The table.
+ */
+void freeTranspositionTable(TranspositionTable *table);
+
+/**
+ * @brief Returns the table searches use unless they are given another one.
+ *
+ * @return The table.
+ */
+TranspositionTable *getSharedTranspositionTable();
+
+/**
+ * @brief Returns the Zobrist key of a position.
+ *
+ * @param position The position.
+ * @param player The colour of the side to move.
+ * @return The key.
+ */
+uint64_t getHashKey(Position &position, Player player);
+
+/**
+ * @brief Returns the key change of a move, including the change of side.
+ *
+ * @param player The colour of the side that moves.
+ * @param square The square index of the move.
+ * @param flips The discs the move flipped.
+ * @return The value to XOR into the key.
+ */
+uint64_t getMoveHashKey(Player player, int square, Bitboard flips);
+
+/**
+ * @brief Returns the key change of a pass.
+ *
+ * @return The value to XOR into the key.
+ */
+uint64_t getPassHashKey();
+
+/**
+ * @brief Looks up a position in a transposition table.
+ *
+ * @param table The table.
+ * @param key The position's key.
+ * @param entry Receives the entry, if found.
+ * @return Entry found.
+ */
+bool probeTranspositionTable(TranspositionTable *table, uint64_t key, TTEntry &entry);
+
+/**
+ * @brief Stores a search result in a transposition table.
+ *
+ * @param table The table.
+ * @param key The position's key.
+ * @param depth The search depth.
+ * @param score The score.
+ * @param bound Whether the score is exact, a lower or an upper bound.
+ * @param move The best move's square index, or TT_NO_MOVE.
+ */
+void storeTranspositionTable(TranspositionTable *table, uint64_t key, int depth, int score, TTBound bound, int move);
+
+/**
+ * @brief Starts a new search, so entries from older searches are replaced first.
+ *
+ * @param table The table.
+ */
+void ageTranspositionTable(TranspositionTable *table);
+
+/**
+ * @brief Empties a transposition table.
+ *
+ * @param table The table.
+ */
+void clearTranspositionTable(TranspositionTable *table);
+
+#endif
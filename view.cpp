@@ -5,13 +5,16 @@
  * @copyright Copyright (c) 2023-2024
  */
 
+#include <cstdio>
 #include <string>
 #include <math.h>
 
 #include "raylib.h"
 
+#include "ai.h"
 #include "controller.h"
 #include "model.h"
+#include "trace.h"
 
 #define GAME_NAME "EDAversi"
 
@@ -58,6 +61,10 @@
 #define INFO_PLAYWHITE_BUTTON_X INFO_CENTERED_X
 #define INFO_PLAYWHITE_BUTTON_Y (WINDOW_HEIGHT * 7 / 8)
 
+#define STATS_FONT_SIZE 16
+#define STATS_LINE_HEIGHT 20
+#define STATS_Y (INFO_TITLE_Y + TITLE_FONT_SIZE / 2 + STATS_LINE_HEIGHT)
+
 void initView()
 {
     InitWindow(WINDOW_WIDTH, WINDOW_HEIGHT, GAME_NAME);
@@ -167,8 +174,45 @@ static bool isMousePointerOverButton(Vector2 position)
             (mousePosition.y < (position.y + INFO_BUTTON_HEIGHT / 2)));
 }
 
-void drawView(GameModel &model)
+/**
+ * @brief Draws the statistics of the AI's last search.
+ *
+ * @param info What the search found.
+ */
+static void drawSearchStats(SearchInfo &info)
+{
+    SearchStats &stats = info.stats;
+    char lines[5][64];
+
+    if (info.book)
+        snprintf(lines[0], sizeof(lines[0]), "Book move, score %+d", info.score);
+    else
+        snprintf(lines[0], sizeof(lines[0]), "Depth %d, score %+d", info.depth, info.score);
+    snprintf(lines[1], sizeof(lines[1]), "%.2f Mnodes in %.2f s, %.2f Mnodes/s",
+             info.nodes / 1e6,
+             info.time,
+             info.time ? info.nodes / info.time / 1e6 : 0.0);
+    snprintf(lines[2], sizeof(lines[2]), "Branching factor %.2f, %.2f Mleaves",
+             getBranchingFactor(stats),
+             stats.leaves / 1e6);
+    snprintf(lines[3], sizeof(lines[3]), "Cutoffs %.0f%%, first move %.0f%%",
+             stats.expandedNodes ? 100.0 * stats.betaCutoffs / stats.expandedNodes : 0.0,
+             stats.betaCutoffs ? 100.0 * stats.firstMoveCutoffs / stats.betaCutoffs : 0.0);
+    snprintf(lines[4], sizeof(lines[4]), "TT hits %.0f%%, cutoffs %.0f%%",
+             stats.ttProbes ? 100.0 * stats.ttHits / stats.ttProbes : 0.0,
+             stats.ttProbes ? 100.0 * stats.ttCutoffs / stats.ttProbes : 0.0);
+
+    for (int i = 0; i < 5; i++)
+        drawCenteredText({INFO_CENTERED_X,
+                          (float)(STATS_Y + i * STATS_LINE_HEIGHT)},
+                         STATS_FONT_SIZE,
+                         lines[i]);
+}
+
+void drawView(GameModel &model, SearchInfo *searchInfo)
 {
+    TRACE_SCOPE("drawView");
+
     BeginDrawing();
 
     ClearBackground(BEIGE);
@@ -220,6 +264,8 @@ void drawView(GameModel &model)
                       INFO_TITLE_Y},
                      TITLE_FONT_SIZE,
                      GAME_NAME);
+    if (searchInfo)
+        drawSearchStats(*searchInfo);
     drawScore("White score: ",
               {INFO_CENTERED_X,
                INFO_BLACK_SCORE_Y},
@@ -243,6 +289,8 @@ void drawView(GameModel &model)
                    WHITE);
     }
 
+    // Espera la sincronización vertical
+    TRACE_SCOPE("EndDrawing");
     EndDrawing();
 }
 
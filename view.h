@@ -8,6 +8,7 @@
 #ifndef VIEW_H
 #define VIEW_H
 
+#include "ai.h"
 #include "model.h"
 
 /**
@@ -24,8 +25,9 @@ void freeView();
  * @brief Draws the game view.
  *
  * @param model The game model.
+ * @param searchInfo If not null, the search statistics to show next to the timers.
  */
-void drawView(GameModel &model);
+void drawView(GameModel &model, SearchInfo *searchInfo = nullptr);
 
 /**
  * @brief Returns the square over the mouse pointer.